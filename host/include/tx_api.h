@@ -0,0 +1,295 @@
+/**
+ * @file      tx_api.h
+ * @brief     ThreadX API of the host backend
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef TX_API_H
+#define TX_API_H
+
+/* The host backend implements the subset of the ThreadX API used by the wrapper library
+ * on the C++ standard thread support library, so the applications built on the wrappers
+ * can run as native processes. It's selected by taking host/include as the ThreadX include path,
+ * and compiling host/src/tx_host.cpp instead of the kernel and its port.
+ *
+ * The threads run in parallel, as on an SMP port, with the following limitations:
+ * - the thread priorities and preemption thresholds are recorded, but don't affect the scheduling
+ * - suspending another thread takes effect once it calls a kernel service
+ * - terminating a running thread makes it unwind its stack (by a C++ exception) once it calls
+ *   a kernel service, and deleting the thread waits for that, so a terminated thread that
+ *   computes without calling any services blocks its deletion until it does
+ */
+
+#ifdef TX_INCLUDE_USER_DEFINE_FILE
+#include "tx_user.h"
+#endif
+
+#include <assert.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define VOID                                    void
+typedef char                                    CHAR;
+typedef unsigned char                           UCHAR;
+typedef int                                     INT;
+typedef unsigned int                            UINT;
+typedef long                                    LONG;
+typedef unsigned long                           ULONG;
+typedef unsigned long long                      ULONG64;
+typedef short                                   SHORT;
+typedef unsigned short                          USHORT;
+
+/* there is no separate error checking layer */
+#ifndef TX_DISABLE_ERROR_CHECKING
+#define TX_DISABLE_ERROR_CHECKING
+#endif
+
+/* the host threads run in parallel */
+#ifndef TX_THREAD_SMP_MAX_CORES
+#define TX_THREAD_SMP_MAX_CORES                 4
+#endif
+#define TX_SMP_CORE_ID                          _tx_thread_smp_core_get()
+
+#ifndef TX_MAX_PRIORITIES
+#define TX_MAX_PRIORITIES                       32
+#endif
+#ifndef TX_TIMER_TICKS_PER_SECOND
+#define TX_TIMER_TICKS_PER_SECOND               ((ULONG) 1000)
+#endif
+#ifndef TX_TIMER_THREAD_STACK_SIZE
+#define TX_TIMER_THREAD_STACK_SIZE              1024
+#endif
+#define TX_MINIMUM_STACK                        200
+
+/* nanosecond resolution timestamps, see this_cpu::get_timestamp() */
+#ifndef TX_TRACE_TIME_SOURCE
+#define TX_TRACE_TIME_SOURCE                    _tx_host_time_stamp_get()
+#endif
+
+/* the wrapper library's thread observation, see README.md */
+#ifndef TX_THREAD_USER_EXTENSION
+#define TX_THREAD_USER_EXTENSION                VOID *entry_exit_param_;
+#endif
+
+#define TX_NULL                                 ((void *) 0)
+#define TX_TRUE                                 ((UINT) 1)
+#define TX_FALSE                                ((UINT) 0)
+#define TX_NO_WAIT                              ((ULONG) 0)
+#define TX_WAIT_FOREVER                         ((ULONG) 0xFFFFFFFFUL)
+#define TX_AUTO_START                           ((UINT) 1)
+#define TX_DONT_START                           ((UINT) 0)
+#define TX_AUTO_ACTIVATE                        ((UINT) 1)
+#define TX_NO_ACTIVATE                          ((UINT) 0)
+#define TX_INHERIT                              ((UINT) 1)
+#define TX_NO_INHERIT                           ((UINT) 0)
+#define TX_NO_TIME_SLICE                        ((ULONG) 0)
+#define TX_THREAD_ENTRY                         ((UINT) 0)
+#define TX_THREAD_EXIT                          ((UINT) 1)
+
+/* thread states */
+#define TX_READY                                ((UINT) 0)
+#define TX_COMPLETED                            ((UINT) 1)
+#define TX_TERMINATED                           ((UINT) 2)
+#define TX_SUSPENDED                            ((UINT) 3)
+#define TX_SLEEP                                ((UINT) 4)
+#define TX_QUEUE_SUSP                           ((UINT) 5)
+#define TX_SEMAPHORE_SUSP                       ((UINT) 6)
+#define TX_EVENT_FLAG                           ((UINT) 7)
+#define TX_BLOCK_MEMORY                         ((UINT) 8)
+#define TX_BYTE_MEMORY                          ((UINT) 9)
+#define TX_IO_DRIVER                            ((UINT) 10)
+#define TX_FILE                                 ((UINT) 11)
+#define TX_TCP_IP                               ((UINT) 12)
+#define TX_MUTEX_SUSP                           ((UINT) 13)
+#define TX_PRIORITY_CHANGE                      ((UINT) 14)
+
+/* API return values */
+#define TX_SUCCESS                              ((UINT) 0x00)
+#define TX_DELETED                              ((UINT) 0x01)
+#define TX_NO_INSTANCE                          ((UINT) 0x0D)
+#define TX_PRIORITY_ERROR                       ((UINT) 0x0F)
+#define TX_DELETE_ERROR                         ((UINT) 0x11)
+#define TX_RESUME_ERROR                         ((UINT) 0x12)
+#define TX_CALLER_ERROR                         ((UINT) 0x13)
+#define TX_SUSPEND_ERROR                        ((UINT) 0x14)
+#define TX_TICK_ERROR                           ((UINT) 0x16)
+#define TX_ACTIVATE_ERROR                       ((UINT) 0x17)
+#define TX_THRESH_ERROR                         ((UINT) 0x18)
+#define TX_SUSPEND_LIFTED                       ((UINT) 0x19)
+#define TX_WAIT_ABORTED                         ((UINT) 0x1A)
+#define TX_WAIT_ABORT_ERROR                     ((UINT) 0x1B)
+#define TX_NOT_AVAILABLE                        ((UINT) 0x1D)
+#define TX_NOT_OWNED                            ((UINT) 0x1E)
+#define TX_NOT_DONE                             ((UINT) 0x20)
+
+/* the interrupt masking is emulated by a recursive kernel lock */
+#define TX_INT_DISABLE                          ((UINT) 1)
+#define TX_INT_ENABLE                           ((UINT) 0)
+#define TX_INTERRUPT_SAVE_AREA                  unsigned int interrupt_save;
+#define TX_DISABLE                              interrupt_save = _tx_thread_interrupt_control(TX_INT_DISABLE);
+#define TX_RESTORE                              _tx_thread_interrupt_control(interrupt_save);
+
+typedef struct TX_TIMER_INTERNAL_STRUCT
+{
+    ULONG                       tx_timer_internal_remaining_ticks;
+    ULONG                       tx_timer_internal_re_initialize_ticks;
+    VOID                        (*tx_timer_internal_timeout_function)(ULONG id);
+    ULONG                       tx_timer_internal_timeout_param;
+} TX_TIMER_INTERNAL;
+
+typedef struct TX_TIMER_STRUCT
+{
+    CHAR                        *tx_timer_name;
+    TX_TIMER_INTERNAL           tx_timer_internal;
+    VOID                        *tx_timer_host;
+} TX_TIMER;
+
+typedef struct TX_THREAD_STRUCT
+{
+    CHAR                        *tx_thread_name;
+    UINT                        tx_thread_state;
+    UINT                        tx_thread_priority;
+    UINT                        tx_thread_preempt_threshold;
+    UINT                        tx_thread_user_priority;
+    UINT                        tx_thread_user_preempt_threshold;
+    VOID                        *tx_thread_stack_start;
+    VOID                        *tx_thread_stack_end;
+    VOID                        *tx_thread_stack_ptr;
+    ULONG                       tx_thread_stack_size;
+    VOID                        (*tx_thread_entry)(ULONG id);
+    ULONG                       tx_thread_entry_parameter;
+    TX_TIMER_INTERNAL           tx_thread_timer;
+    VOID                        (*tx_thread_suspend_cleanup)(struct TX_THREAD_STRUCT *thread_ptr, ULONG suspension_sequence);
+    VOID                        *tx_thread_suspend_control_block;
+    struct TX_THREAD_STRUCT     *tx_thread_suspended_next;
+    struct TX_THREAD_STRUCT     *tx_thread_suspended_previous;
+    UINT                        tx_thread_suspend_status;
+    UINT                        tx_thread_suspending;
+    ULONG                       tx_thread_suspension_sequence;
+    VOID                        (*tx_thread_entry_exit_notify)(struct TX_THREAD_STRUCT *thread_ptr, UINT type);
+    VOID                        *tx_thread_host;
+    TX_THREAD_USER_EXTENSION
+} TX_THREAD;
+
+typedef struct TX_MUTEX_STRUCT
+{
+    CHAR                        *tx_mutex_name;
+    UINT                        tx_mutex_ownership_count;
+    TX_THREAD                   *tx_mutex_owner;
+    UINT                        tx_mutex_inherit;
+    UINT                        tx_mutex_suspended_count;
+    VOID                        *tx_mutex_host;
+} TX_MUTEX;
+
+typedef struct TX_SEMAPHORE_STRUCT
+{
+    CHAR                        *tx_semaphore_name;
+    ULONG                       tx_semaphore_count;
+    UINT                        tx_semaphore_suspended_count;
+    VOID                        *tx_semaphore_host;
+} TX_SEMAPHORE;
+
+/* the services are called directly */
+#define tx_kernel_enter                         _tx_initialize_kernel_enter
+
+#define tx_mutex_create                         _tx_mutex_create
+#define tx_mutex_delete                         _tx_mutex_delete
+#define tx_mutex_get                            _tx_mutex_get
+#define tx_mutex_put                            _tx_mutex_put
+
+#define tx_semaphore_create                     _tx_semaphore_create
+#define tx_semaphore_delete                     _tx_semaphore_delete
+#define tx_semaphore_get                        _tx_semaphore_get
+#define tx_semaphore_put                        _tx_semaphore_put
+
+#define tx_thread_create                        _tx_thread_create
+#define tx_thread_delete                        _tx_thread_delete
+#define tx_thread_entry_exit_notify             _tx_thread_entry_exit_notify
+#define tx_thread_identify                      _tx_thread_identify
+#define tx_thread_preemption_change             _tx_thread_preemption_change
+#define tx_thread_priority_change               _tx_thread_priority_change
+#define tx_thread_relinquish                    _tx_thread_relinquish
+#define tx_thread_resume                        _tx_thread_resume
+#define tx_thread_sleep                         _tx_thread_sleep
+#define tx_thread_suspend                       _tx_thread_suspend
+#define tx_thread_terminate                     _tx_thread_terminate
+#define tx_thread_wait_abort                    _tx_thread_wait_abort
+
+#define tx_time_get                             _tx_time_get
+
+#define tx_timer_activate                       _tx_timer_activate
+#define tx_timer_change                         _tx_timer_change
+#define tx_timer_create                         _tx_timer_create
+#define tx_timer_deactivate                     _tx_timer_deactivate
+#define tx_timer_delete                         _tx_timer_delete
+
+VOID        tx_application_define(VOID *first_unused_memory);
+ULONG       _tx_host_time_stamp_get(VOID);
+VOID        _tx_initialize_kernel_enter(VOID);
+
+UINT        _tx_mutex_create(TX_MUTEX *mutex_ptr, CHAR *name_ptr, UINT inherit);
+UINT        _tx_mutex_delete(TX_MUTEX *mutex_ptr);
+UINT        _tx_mutex_get(TX_MUTEX *mutex_ptr, ULONG wait_option);
+UINT        _tx_mutex_put(TX_MUTEX *mutex_ptr);
+
+UINT        _tx_semaphore_create(TX_SEMAPHORE *semaphore_ptr, CHAR *name_ptr, ULONG initial_count);
+UINT        _tx_semaphore_delete(TX_SEMAPHORE *semaphore_ptr);
+UINT        _tx_semaphore_get(TX_SEMAPHORE *semaphore_ptr, ULONG wait_option);
+UINT        _tx_semaphore_put(TX_SEMAPHORE *semaphore_ptr);
+
+UINT        _tx_thread_create(TX_THREAD *thread_ptr, CHAR *name_ptr,
+                VOID (*entry_function)(ULONG entry_input), ULONG entry_input,
+                VOID *stack_start, ULONG stack_size,
+                UINT priority, UINT preempt_threshold,
+                ULONG time_slice, UINT auto_start);
+UINT        _tx_thread_delete(TX_THREAD *thread_ptr);
+UINT        _tx_thread_entry_exit_notify(TX_THREAD *thread_ptr, VOID (*thread_entry_exit_notify)(TX_THREAD *notify_thread_ptr, UINT type));
+TX_THREAD  *_tx_thread_identify(VOID);
+UINT        _tx_thread_interrupt_control(UINT new_posture);
+UINT        _tx_thread_preemption_change(TX_THREAD *thread_ptr, UINT new_threshold, UINT *old_threshold);
+UINT        _tx_thread_priority_change(TX_THREAD *thread_ptr, UINT new_priority, UINT *old_priority);
+VOID        _tx_thread_relinquish(VOID);
+UINT        _tx_thread_resume(TX_THREAD *thread_ptr);
+UINT        _tx_thread_sleep(ULONG timer_ticks);
+UINT        _tx_thread_smp_core_get(VOID);
+UINT        _tx_thread_suspend(TX_THREAD *thread_ptr);
+UINT        _tx_thread_terminate(TX_THREAD *thread_ptr);
+UINT        _tx_thread_wait_abort(TX_THREAD *thread_ptr);
+
+ULONG       _tx_time_get(VOID);
+
+UINT        _tx_timer_activate(TX_TIMER *timer_ptr);
+UINT        _tx_timer_change(TX_TIMER *timer_ptr, ULONG initial_ticks, ULONG reschedule_ticks);
+UINT        _tx_timer_create(TX_TIMER *timer_ptr, CHAR *name_ptr,
+                VOID (*expiration_function)(ULONG input), ULONG expiration_input,
+                ULONG initial_ticks, ULONG reschedule_ticks, UINT auto_activate);
+UINT        _tx_timer_deactivate(TX_TIMER *timer_ptr);
+UINT        _tx_timer_delete(TX_TIMER *timer_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TX_API_H */
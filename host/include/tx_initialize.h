@@ -0,0 +1,35 @@
+/**
+ * @file      tx_initialize.h
+ * @brief     ThreadX initialization states of the host backend
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef TX_INITIALIZE_H
+#define TX_INITIALIZE_H
+
+/* The initialization states of the host backend, which is always running. */
+
+#define TX_INITIALIZE_IS_FINISHED               ((ULONG) 0x00000000UL)
+#define TX_INITIALIZE_ALMOST_DONE               ((ULONG) 0xF0F0F0F0UL)
+#define TX_INITIALIZE_IN_PROGRESS               ((ULONG) 0xF0F0F0F1UL)
+
+#endif /* TX_INITIALIZE_H */
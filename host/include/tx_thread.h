@@ -0,0 +1,51 @@
+/**
+ * @file      tx_thread.h
+ * @brief     ThreadX thread internals of the host backend
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef TX_THREAD_H
+#define TX_THREAD_H
+
+/* The thread internals of the host backend, used by the wrapper library's low-level primitives. */
+
+#include "tx_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern volatile ULONG           _tx_thread_system_state;
+extern volatile UINT            _tx_thread_preempt_disable;
+
+#define TX_THREAD_GET_SYSTEM_STATE()            _tx_thread_system_state
+#define TX_THREAD_GET_CURRENT(a)                (a) = _tx_thread_identify();
+
+VOID        _tx_thread_system_preempt_check(VOID);
+VOID        _tx_thread_system_resume(TX_THREAD *thread_ptr);
+VOID        _tx_thread_system_suspend(TX_THREAD *thread_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TX_THREAD_H */
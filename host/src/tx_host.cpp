@@ -0,0 +1,946 @@
+/**
+ * @file      tx_host.cpp
+ * @brief     ThreadX services implemented on the C++ standard thread support library
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace threadx
+{
+    namespace native
+    {
+        #include "tx_api.h"
+        #include "tx_thread.h"
+    }
+}
+using namespace threadx::native;
+
+// the services are implemented here, not called
+#undef tx_thread_entry_exit_notify
+
+volatile ULONG threadx::native::_tx_thread_system_state = 0;
+volatile UINT threadx::native::_tx_thread_preempt_disable = 0;
+
+namespace
+{
+    using clock = std::chrono::steady_clock;
+    using tick_duration = std::chrono::duration<clock::rep, std::ratio<1, TX_TIMER_TICKS_PER_SECOND>>;
+    using kernel_lock = std::unique_lock<std::recursive_mutex>;
+
+    // the state is constructed on first use, as the wrappers may be
+    // statically constructed in other translation units
+    std::recursive_mutex& kernel()
+    {
+        static std::recursive_mutex m;
+        return m;
+    }
+
+    clock::time_point epoch()
+    {
+        static const clock::time_point t = clock::now();
+        return t;
+    }
+
+    ULONG ticks_now()
+    {
+        return static_cast<ULONG>(std::chrono::duration_cast<tick_duration>(clock::now() - epoch()).count());
+    }
+
+    clock::time_point tick_time(ULONG ticks)
+    {
+        return epoch() + std::chrono::duration_cast<clock::duration>(tick_duration(ticks));
+    }
+
+    // the waits end on the tick boundaries, as with the kernel's tick driven timeouts
+    clock::time_point deadline(ULONG timeout)
+    {
+        return tick_time(ticks_now() + timeout);
+    }
+
+
+    struct host_thread
+    {
+        std::thread os;
+        std::condition_variable_any cv;
+        std::condition_variable_any *waiting = nullptr;
+        std::atomic<bool> suspend_pending { false };
+        bool started = false;
+        bool finished = false;
+        bool aborted = false;
+        bool terminated = false;
+    };
+
+    // unwinds the stack of a terminated thread
+    struct thread_exit
+    {
+    };
+
+    host_thread* host(TX_THREAD *t)
+    {
+        return static_cast<host_thread*>(t->tx_thread_host);
+    }
+
+    thread_local TX_THREAD *current = nullptr;
+
+    void init_thread(TX_THREAD *t, CHAR *name, UINT priority, UINT preempt_threshold)
+    {
+        memset(t, 0, sizeof(*t));
+        t->tx_thread_name = name;
+        t->tx_thread_priority = priority;
+        t->tx_thread_user_priority = priority;
+        t->tx_thread_preempt_threshold = preempt_threshold;
+        t->tx_thread_user_preempt_threshold = preempt_threshold;
+        t->tx_thread_host = new host_thread();
+    }
+
+    TX_THREAD* current_thread()
+    {
+        if (current == nullptr)
+        {
+            // threads not created by the backend (e.g. main) are adopted on first use,
+            // and are never deleted
+            static char name[] = "host";
+            auto *t = new TX_THREAD;
+            init_thread(t, name, TX_MAX_PRIORITIES / 2, TX_MAX_PRIORITIES / 2);
+            host(t)->started = true;
+            t->tx_thread_state = TX_READY;
+            current = t;
+        }
+        return current;
+    }
+
+    /// @brief  Blocks the calling thread on the condition variable, until the predicate is satisfied,
+    ///         the timeout expires, or the wait is aborted.
+    /// @return TX_SUCCESS, TX_NO_INSTANCE on timeout, or TX_WAIT_ABORTED
+    template<typename Predicate>
+    UINT wait(kernel_lock& lock, std::condition_variable_any& cv, UINT state, ULONG timeout, Predicate pred)
+    {
+        TX_THREAD *t = current_thread();
+        host_thread *h = host(t);
+
+        h->aborted = false;
+        h->waiting = &cv;
+        t->tx_thread_state = state;
+
+        auto done = [&]() { return pred() || h->aborted || h->terminated; };
+        bool satisfied;
+        if (timeout == TX_WAIT_FOREVER)
+        {
+            cv.wait(lock, done);
+            satisfied = true;
+        }
+        else
+        {
+            satisfied = cv.wait_until(lock, deadline(timeout), done);
+        }
+
+        h->waiting = nullptr;
+        if (h->terminated)
+        {
+            // the caller completes the termination with checkpoint(), when the lock is released
+            return TX_WAIT_ABORTED;
+        }
+        t->tx_thread_state = TX_READY;
+        if (h->aborted)
+        {
+            h->aborted = false;
+            return TX_WAIT_ABORTED;
+        }
+        return satisfied ? TX_SUCCESS : TX_NO_INSTANCE;
+    }
+
+    /// @brief  Carries out the suspension or termination of the calling thread,
+    ///         requested by another thread. Must be called without the kernel lock held.
+    void checkpoint()
+    {
+        TX_THREAD *t = current_thread();
+        host_thread *h = host(t);
+        if (h->suspend_pending)
+        {
+            kernel_lock lock(kernel());
+            if (h->suspend_pending.exchange(false) && !h->terminated)
+            {
+                t->tx_thread_state = TX_SUSPENDED;
+                h->cv.wait(lock, [t, h]() { return (t->tx_thread_state != TX_SUSPENDED) || h->terminated; });
+            }
+        }
+        if (h->terminated)
+        {
+            throw thread_exit();
+        }
+    }
+
+    // a thread waiting on a semaphore or mutex
+    struct host_waiter
+    {
+        TX_THREAD *thread;
+        host_waiter *next;
+        bool granted;
+        bool deleted;
+    };
+
+    // the waiting threads of a semaphore or mutex, which are resumed in FIFO order,
+    // handing the object over to them as ThreadX does
+    struct host_object
+    {
+        host_waiter *head = nullptr;
+        host_waiter *tail = nullptr;
+
+        /// @brief  Resumes the longest waiting thread.
+        /// @return The resumed thread, or nullptr if no thread is waiting
+        TX_THREAD* wake()
+        {
+            host_waiter *w = head;
+            if (w == nullptr)
+            {
+                return nullptr;
+            }
+            head = w->next;
+            if (head == nullptr)
+            {
+                tail = nullptr;
+            }
+            w->granted = true;
+            w->thread->tx_thread_state = TX_READY;
+            host(w->thread)->cv.notify_all();
+            return w->thread;
+        }
+
+        /// @brief  Resumes all waiting threads with TX_DELETED, as the object is deleted.
+        void wake_deleted()
+        {
+            for (host_waiter *w = head; w != nullptr; w = w->next)
+            {
+                w->deleted = true;
+            }
+            while (wake() != nullptr)
+            {
+            }
+        }
+
+        void remove(host_waiter *w)
+        {
+            host_waiter *prev = nullptr;
+            for (host_waiter *i = head; i != nullptr; prev = i, i = i->next)
+            {
+                if (i == w)
+                {
+                    (prev != nullptr ? prev->next : head) = w->next;
+                    if (tail == w)
+                    {
+                        tail = prev;
+                    }
+                    break;
+                }
+            }
+        }
+    };
+
+    /// @brief  Blocks the calling thread until the object is handed over to it by @ref host_object::wake,
+    ///         maintaining the object's suspended count, except for the wake, which decrements it.
+    /// @return TX_SUCCESS, TX_NO_INSTANCE on timeout, TX_DELETED if the object is deleted, or TX_WAIT_ABORTED
+    UINT suspend(kernel_lock& lock, host_object *obj, UINT& suspended_count, UINT state, ULONG timeout)
+    {
+        TX_THREAD *t = current_thread();
+        host_waiter w { t, nullptr, false, false };
+        (obj->tail != nullptr ? obj->tail->next : obj->head) = &w;
+        obj->tail = &w;
+        suspended_count++;
+
+        auto result = wait(lock, host(t)->cv, state, timeout, [&w]() { return w.granted; });
+        if (w.granted)
+        {
+            // a terminated thread still unwinds in the caller's checkpoint(),
+            // the control block of a deleted object isn't touched anymore
+            return host(t)->terminated ? TX_WAIT_ABORTED : (w.deleted ? TX_DELETED : TX_SUCCESS);
+        }
+        obj->remove(&w);
+        suspended_count--;
+        return result;
+    }
+
+    host_object* host(TX_MUTEX *m)
+    {
+        return static_cast<host_object*>(m->tx_mutex_host);
+    }
+
+    host_object* host(TX_SEMAPHORE *s)
+    {
+        return static_cast<host_object*>(s->tx_semaphore_host);
+    }
+
+    void thread_main(TX_THREAD *t)
+    {
+        host_thread *h = host(t);
+        current = t;
+
+        kernel_lock lock(kernel());
+        h->cv.wait(lock, [t]() { return t->tx_thread_state != TX_SUSPENDED; });
+        if (t->tx_thread_state == TX_TERMINATED)
+        {
+            return;
+        }
+        h->started = true;
+        auto notify = t->tx_thread_entry_exit_notify;
+        lock.unlock();
+
+        try
+        {
+            if (notify != nullptr)
+            {
+                notify(t, TX_THREAD_ENTRY);
+            }
+            t->tx_thread_entry(t->tx_thread_entry_parameter);
+        }
+        catch (const thread_exit&)
+        {
+        }
+
+        lock.lock();
+        h->finished = true;
+        notify = t->tx_thread_entry_exit_notify;
+        lock.unlock();
+
+        if (notify != nullptr)
+        {
+            notify(t, TX_THREAD_EXIT);
+        }
+
+        lock.lock();
+        if (t->tx_thread_state != TX_TERMINATED)
+        {
+            t->tx_thread_state = TX_COMPLETED;
+        }
+    }
+
+    struct host_timer
+    {
+        clock::time_point expiry;
+        bool active = false;
+    };
+
+    host_timer* host(TX_TIMER *t)
+    {
+        return static_cast<host_timer*>(t->tx_timer_host);
+    }
+
+    // a single thread takes the role of the kernel's timer thread
+    struct timer_service
+    {
+        std::vector<TX_TIMER*> active;
+        std::condition_variable_any cv;
+        TX_TIMER *running = nullptr;
+        std::thread::id id;
+        bool started = false;
+
+        void run()
+        {
+            kernel_lock lock(kernel());
+            id = std::this_thread::get_id();
+            while (true)
+            {
+                TX_TIMER *next = nullptr;
+                for (auto *t : active)
+                {
+                    if ((next == nullptr) || (host(t)->expiry < host(next)->expiry))
+                    {
+                        next = t;
+                    }
+                }
+                if (next == nullptr)
+                {
+                    cv.wait(lock);
+                    continue;
+                }
+                // the timer may be deleted during the wait
+                auto expiry = host(next)->expiry;
+                if (clock::now() < expiry)
+                {
+                    cv.wait_until(lock, expiry);
+                    continue;
+                }
+
+                auto &internal = next->tx_timer_internal;
+                if (internal.tx_timer_internal_re_initialize_ticks != 0)
+                {
+                    host(next)->expiry += std::chrono::duration_cast<clock::duration>(
+                            tick_duration(internal.tx_timer_internal_re_initialize_ticks));
+                }
+                else
+                {
+                    remove(next);
+                }
+
+                // the expiration function runs without the kernel lock held, as in thread context
+                running = next;
+                auto fn = internal.tx_timer_internal_timeout_function;
+                auto param = internal.tx_timer_internal_timeout_param;
+                lock.unlock();
+                fn(param);
+                lock.lock();
+                running = nullptr;
+                cv.notify_all();
+            }
+        }
+
+        void insert(TX_TIMER *t, ULONG ticks)
+        {
+            if (!started)
+            {
+                std::thread([this]() { run(); }).detach();
+                started = true;
+            }
+            host(t)->expiry = deadline(ticks);
+            host(t)->active = true;
+            active.push_back(t);
+            cv.notify_all();
+        }
+
+        void remove(TX_TIMER *t)
+        {
+            for (auto it = active.begin(); it != active.end(); ++it)
+            {
+                if (*it == t)
+                {
+                    active.erase(it);
+                    break;
+                }
+            }
+            host(t)->active = false;
+            cv.notify_all();
+        }
+    };
+
+    timer_service& timers()
+    {
+        static timer_service *s = new timer_service();
+        return *s;
+    }
+}
+
+ULONG threadx::native::_tx_host_time_stamp_get()
+{
+    return static_cast<ULONG>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - epoch()).count());
+}
+
+// the application definition is optional, as the backend is running from the start
+__attribute__((weak)) VOID threadx::native::tx_application_define(VOID *first_unused_memory)
+{
+    (void)first_unused_memory;
+}
+
+VOID threadx::native::_tx_initialize_kernel_enter()
+{
+    // the threads already created are executing, the application definition only adds to them
+    tx_application_define(nullptr);
+    while (true)
+    {
+        std::this_thread::sleep_for(std::chrono::hours(1));
+    }
+}
+
+UINT threadx::native::_tx_thread_interrupt_control(UINT new_posture)
+{
+    if (new_posture == TX_INT_DISABLE)
+    {
+        kernel().lock();
+    }
+    else
+    {
+        kernel().unlock();
+    }
+    return TX_INT_ENABLE;
+}
+
+UINT threadx::native::_tx_thread_smp_core_get()
+{
+    static std::atomic<UINT> next { 0 };
+    thread_local UINT core = next++ % TX_THREAD_SMP_MAX_CORES;
+    return core;
+}
+
+ULONG threadx::native::_tx_time_get()
+{
+    return ticks_now();
+}
+
+UINT threadx::native::_tx_mutex_create(TX_MUTEX *mutex_ptr, CHAR *name_ptr, UINT inherit)
+{
+    memset(mutex_ptr, 0, sizeof(*mutex_ptr));
+    mutex_ptr->tx_mutex_name = name_ptr;
+    mutex_ptr->tx_mutex_inherit = inherit;
+    mutex_ptr->tx_mutex_host = new host_object();
+    return TX_SUCCESS;
+}
+
+UINT threadx::native::_tx_mutex_delete(TX_MUTEX *mutex_ptr)
+{
+    kernel_lock lock(kernel());
+    // the waiting threads return unsuccessfully
+    host(mutex_ptr)->wake_deleted();
+    mutex_ptr->tx_mutex_suspended_count = 0;
+    delete host(mutex_ptr);
+    mutex_ptr->tx_mutex_host = nullptr;
+    return TX_SUCCESS;
+}
+
+UINT threadx::native::_tx_mutex_get(TX_MUTEX *mutex_ptr, ULONG wait_option)
+{
+    checkpoint();
+    TX_THREAD *self = current_thread();
+    kernel_lock lock(kernel());
+    if (mutex_ptr->tx_mutex_owner == nullptr)
+    {
+        mutex_ptr->tx_mutex_owner = self;
+        mutex_ptr->tx_mutex_ownership_count = 1;
+        return TX_SUCCESS;
+    }
+    if (mutex_ptr->tx_mutex_owner == self)
+    {
+        mutex_ptr->tx_mutex_ownership_count++;
+        return TX_SUCCESS;
+    }
+    if (wait_option == TX_NO_WAIT)
+    {
+        return TX_NOT_AVAILABLE;
+    }
+
+    // the ownership is handed over by the put
+    auto result = suspend(lock, host(mutex_ptr), mutex_ptr->tx_mutex_suspended_count, TX_MUTEX_SUSP, wait_option);
+    if (result != TX_SUCCESS)
+    {
+        lock.unlock();
+        checkpoint();
+        return (result == TX_NO_INSTANCE) ? TX_NOT_AVAILABLE : result;
+    }
+    return TX_SUCCESS;
+}
+
+UINT threadx::native::_tx_mutex_put(TX_MUTEX *mutex_ptr)
+{
+    TX_THREAD *self = current_thread();
+    kernel_lock lock(kernel());
+    if (mutex_ptr->tx_mutex_owner != self)
+    {
+        return TX_NOT_OWNED;
+    }
+    if (--mutex_ptr->tx_mutex_ownership_count == 0)
+    {
+        TX_THREAD *next = host(mutex_ptr)->wake();
+        mutex_ptr->tx_mutex_owner = next;
+        if (next != nullptr)
+        {
+            mutex_ptr->tx_mutex_suspended_count--;
+            mutex_ptr->tx_mutex_ownership_count = 1;
+        }
+    }
+    return TX_SUCCESS;
+}
+
+UINT threadx::native::_tx_semaphore_create(TX_SEMAPHORE *semaphore_ptr, CHAR *name_ptr, ULONG initial_count)
+{
+    memset(semaphore_ptr, 0, sizeof(*semaphore_ptr));
+    semaphore_ptr->tx_semaphore_name = name_ptr;
+    semaphore_ptr->tx_semaphore_count = initial_count;
+    semaphore_ptr->tx_semaphore_host = new host_object();
+    return TX_SUCCESS;
+}
+
+UINT threadx::native::_tx_semaphore_delete(TX_SEMAPHORE *semaphore_ptr)
+{
+    kernel_lock lock(kernel());
+    // the waiting threads return unsuccessfully
+    host(semaphore_ptr)->wake_deleted();
+    semaphore_ptr->tx_semaphore_suspended_count = 0;
+    delete host(semaphore_ptr);
+    semaphore_ptr->tx_semaphore_host = nullptr;
+    return TX_SUCCESS;
+}
+
+UINT threadx::native::_tx_semaphore_get(TX_SEMAPHORE *semaphore_ptr, ULONG wait_option)
+{
+    checkpoint();
+    kernel_lock lock(kernel());
+    if (semaphore_ptr->tx_semaphore_count > 0)
+    {
+        semaphore_ptr->tx_semaphore_count--;
+        return TX_SUCCESS;
+    }
+    if (wait_option == TX_NO_WAIT)
+    {
+        return TX_NO_INSTANCE;
+    }
+
+    // the count is handed over by the put
+    auto result = suspend(lock, host(semaphore_ptr), semaphore_ptr->tx_semaphore_suspended_count,
+            TX_SEMAPHORE_SUSP, wait_option);
+    if (result != TX_SUCCESS)
+    {
+        lock.unlock();
+        checkpoint();
+    }
+    return result;
+}
+
+UINT threadx::native::_tx_semaphore_put(TX_SEMAPHORE *semaphore_ptr)
+{
+    kernel_lock lock(kernel());
+    if (host(semaphore_ptr)->wake() != nullptr)
+    {
+        semaphore_ptr->tx_semaphore_suspended_count--;
+    }
+    else
+    {
+        semaphore_ptr->tx_semaphore_count++;
+    }
+    return TX_SUCCESS;
+}
+
+UINT threadx::native::_tx_thread_create(TX_THREAD *thread_ptr, CHAR *name_ptr,
+        VOID (*entry_function)(ULONG entry_input), ULONG entry_input,
+        VOID *stack_start, ULONG stack_size,
+        UINT priority, UINT preempt_threshold,
+        ULONG time_slice, UINT auto_start)
+{
+    (void)time_slice;
+    if (priority >= TX_MAX_PRIORITIES)
+    {
+        return TX_PRIORITY_ERROR;
+    }
+    if (preempt_threshold > priority)
+    {
+        return TX_THRESH_ERROR;
+    }
+    kernel_lock lock(kernel());
+    init_thread(thread_ptr, name_ptr, priority, preempt_threshold);
+    thread_ptr->tx_thread_entry = entry_function;
+    thread_ptr->tx_thread_entry_parameter = entry_input;
+    // the stack memory isn't used, the OS thread has its own
+    thread_ptr->tx_thread_stack_start = stack_start;
+    thread_ptr->tx_thread_stack_size = stack_size;
+    thread_ptr->tx_thread_stack_end = static_cast<UCHAR*>(stack_start) + stack_size - 1;
+    thread_ptr->tx_thread_stack_ptr = thread_ptr->tx_thread_stack_end;
+    thread_ptr->tx_thread_state = TX_SUSPENDED;
+    host(thread_ptr)->os = std::thread(thread_main, thread_ptr);
+
+    if (auto_start == TX_AUTO_START)
+    {
+        thread_ptr->tx_thread_state = TX_READY;
+        host(thread_ptr)->cv.notify_all();
+    }
+    return TX_SUCCESS;
+}
+
+UINT threadx::native::_tx_thread_delete(TX_THREAD *thread_ptr)
+{
+    {
+        kernel_lock lock(kernel());
+        if ((thread_ptr->tx_thread_state != TX_COMPLETED) && (thread_ptr->tx_thread_state != TX_TERMINATED))
+        {
+            return TX_DELETE_ERROR;
+        }
+    }
+    // a terminated OS thread may still be running until its next service call, where it unwinds,
+    // it can't be detached, as it still uses the thread control block
+    host_thread *h = host(thread_ptr);
+    if (h->os.joinable())
+    {
+        h->os.join();
+    }
+    thread_ptr->tx_thread_host = nullptr;
+    delete h;
+    return TX_SUCCESS;
+}
+
+UINT threadx::native::_tx_thread_entry_exit_notify(TX_THREAD *thread_ptr, VOID (*thread_entry_exit_notify)(TX_THREAD *notify_thread_ptr, UINT type))
+{
+    kernel_lock lock(kernel());
+    thread_ptr->tx_thread_entry_exit_notify = thread_entry_exit_notify;
+    return TX_SUCCESS;
+}
+
+TX_THREAD* threadx::native::_tx_thread_identify()
+{
+    return current_thread();
+}
+
+UINT threadx::native::_tx_thread_preemption_change(TX_THREAD *thread_ptr, UINT new_threshold, UINT *old_threshold)
+{
+    kernel_lock lock(kernel());
+    if (new_threshold > thread_ptr->tx_thread_user_priority)
+    {
+        return TX_THRESH_ERROR;
+    }
+    *old_threshold = thread_ptr->tx_thread_user_preempt_threshold;
+    thread_ptr->tx_thread_user_preempt_threshold = new_threshold;
+    thread_ptr->tx_thread_preempt_threshold = new_threshold;
+    return TX_SUCCESS;
+}
+
+UINT threadx::native::_tx_thread_priority_change(TX_THREAD *thread_ptr, UINT new_priority, UINT *old_priority)
+{
+    if (new_priority >= TX_MAX_PRIORITIES)
+    {
+        return TX_PRIORITY_ERROR;
+    }
+    kernel_lock lock(kernel());
+    *old_priority = thread_ptr->tx_thread_user_priority;
+    thread_ptr->tx_thread_user_priority = new_priority;
+    thread_ptr->tx_thread_priority = new_priority;
+    thread_ptr->tx_thread_user_preempt_threshold = new_priority;
+    thread_ptr->tx_thread_preempt_threshold = new_priority;
+    return TX_SUCCESS;
+}
+
+VOID threadx::native::_tx_thread_relinquish()
+{
+    checkpoint();
+    std::this_thread::yield();
+}
+
+UINT threadx::native::_tx_thread_resume(TX_THREAD *thread_ptr)
+{
+    kernel_lock lock(kernel());
+    host_thread *h = host(thread_ptr);
+    if (thread_ptr->tx_thread_state == TX_SUSPENDED)
+    {
+        thread_ptr->tx_thread_state = TX_READY;
+        h->cv.notify_all();
+        return TX_SUCCESS;
+    }
+    if (h->suspend_pending.exchange(false))
+    {
+        return TX_SUCCESS;
+    }
+    return TX_RESUME_ERROR;
+}
+
+UINT threadx::native::_tx_thread_sleep(ULONG timer_ticks)
+{
+    checkpoint();
+    if (timer_ticks == 0)
+    {
+        return TX_SUCCESS;
+    }
+    kernel_lock lock(kernel());
+    auto result = wait(lock, host(current_thread())->cv, TX_SLEEP, timer_ticks, []() { return false; });
+    lock.unlock();
+    checkpoint();
+    return (result == TX_NO_INSTANCE) ? TX_SUCCESS : result;
+}
+
+UINT threadx::native::_tx_thread_suspend(TX_THREAD *thread_ptr)
+{
+    kernel_lock lock(kernel());
+    if ((thread_ptr->tx_thread_state == TX_COMPLETED) || (thread_ptr->tx_thread_state == TX_TERMINATED))
+    {
+        return TX_SUSPEND_ERROR;
+    }
+    host(thread_ptr)->suspend_pending = true;
+    lock.unlock();
+
+    if (thread_ptr == current_thread())
+    {
+        checkpoint();
+    }
+    return TX_SUCCESS;
+}
+
+UINT threadx::native::_tx_thread_terminate(TX_THREAD *thread_ptr)
+{
+    kernel_lock lock(kernel());
+    host_thread *h = host(thread_ptr);
+    if ((thread_ptr->tx_thread_state == TX_COMPLETED) || (thread_ptr->tx_thread_state == TX_TERMINATED))
+    {
+        return TX_SUCCESS;
+    }
+    thread_ptr->tx_thread_state = TX_TERMINATED;
+    h->cv.notify_all();
+    if (h->started && !h->finished)
+    {
+        // an OS thread can't be stopped from the outside, it unwinds itself
+        // when it's blocked, or as soon as it calls a service
+        h->terminated = true;
+        if (h->waiting != nullptr)
+        {
+            h->waiting->notify_all();
+        }
+        if (thread_ptr == current)
+        {
+            lock.unlock();
+            checkpoint();
+        }
+    }
+    return TX_SUCCESS;
+}
+
+UINT threadx::native::_tx_thread_wait_abort(TX_THREAD *thread_ptr)
+{
+    kernel_lock lock(kernel());
+    host_thread *h = host(thread_ptr);
+    switch (thread_ptr->tx_thread_state)
+    {
+        case TX_READY:
+        case TX_COMPLETED:
+        case TX_TERMINATED:
+        case TX_SUSPENDED:
+            return TX_WAIT_ABORT_ERROR;
+
+        default:
+            h->aborted = true;
+            if (h->waiting != nullptr)
+            {
+                h->waiting->notify_all();
+            }
+            return TX_SUCCESS;
+    }
+}
+
+VOID threadx::native::_tx_thread_system_suspend(TX_THREAD *thread_ptr)
+{
+    kernel_lock lock(kernel());
+    _tx_thread_preempt_disable--;
+
+    // the suspension is prepared by the caller, and it might already be lifted
+    auto timeout = thread_ptr->tx_thread_timer.tx_timer_internal_remaining_ticks;
+    auto result = wait(lock, host(thread_ptr)->cv, thread_ptr->tx_thread_state, timeout,
+            [thread_ptr]() { return thread_ptr->tx_thread_suspending == TX_FALSE; });
+    if (result == TX_SUCCESS)
+    {
+        return;
+    }
+
+    // the cleanup lifts the suspension, unless a resume is already underway
+    auto cleanup = thread_ptr->tx_thread_suspend_cleanup;
+    auto sequence = thread_ptr->tx_thread_suspension_sequence;
+    thread_ptr->tx_thread_state = TX_IO_DRIVER;
+    lock.unlock();
+    if (cleanup != nullptr)
+    {
+        cleanup(thread_ptr, sequence);
+    }
+    lock.lock();
+    thread_ptr->tx_thread_suspending = TX_FALSE;
+    if (result == TX_WAIT_ABORTED)
+    {
+        thread_ptr->tx_thread_suspend_status = TX_WAIT_ABORTED;
+    }
+    if (!host(thread_ptr)->terminated)
+    {
+        thread_ptr->tx_thread_state = TX_READY;
+    }
+    lock.unlock();
+    checkpoint();
+}
+
+VOID threadx::native::_tx_thread_system_resume(TX_THREAD *thread_ptr)
+{
+    kernel_lock lock(kernel());
+    _tx_thread_preempt_disable--;
+    thread_ptr->tx_thread_suspending = TX_FALSE;
+    thread_ptr->tx_thread_state = TX_READY;
+    host(thread_ptr)->cv.notify_all();
+}
+
+VOID threadx::native::_tx_thread_system_preempt_check()
+{
+    // the woken threads run in parallel, there is nothing to switch to
+}
+
+UINT threadx::native::_tx_timer_create(TX_TIMER *timer_ptr, CHAR *name_ptr,
+        VOID (*expiration_function)(ULONG input), ULONG expiration_input,
+        ULONG initial_ticks, ULONG reschedule_ticks, UINT auto_activate)
+{
+    if (initial_ticks == 0)
+    {
+        return TX_TICK_ERROR;
+    }
+    memset(timer_ptr, 0, sizeof(*timer_ptr));
+    timer_ptr->tx_timer_name = name_ptr;
+    timer_ptr->tx_timer_internal.tx_timer_internal_remaining_ticks = initial_ticks;
+    timer_ptr->tx_timer_internal.tx_timer_internal_re_initialize_ticks = reschedule_ticks;
+    timer_ptr->tx_timer_internal.tx_timer_internal_timeout_function = expiration_function;
+    timer_ptr->tx_timer_internal.tx_timer_internal_timeout_param = expiration_input;
+    timer_ptr->tx_timer_host = new host_timer();
+
+    if (auto_activate == TX_AUTO_ACTIVATE)
+    {
+        kernel_lock lock(kernel());
+        timers().insert(timer_ptr, initial_ticks);
+    }
+    return TX_SUCCESS;
+}
+
+UINT threadx::native::_tx_timer_delete(TX_TIMER *timer_ptr)
+{
+    kernel_lock lock(kernel());
+    auto &s = timers();
+    if (host(timer_ptr)->active)
+    {
+        s.remove(timer_ptr);
+    }
+    // wait for the completion of the expiration function, unless called from it
+    s.cv.wait(lock, [&s, timer_ptr]() {
+        return (s.running != timer_ptr) || (s.id == std::this_thread::get_id()); });
+    delete host(timer_ptr);
+    timer_ptr->tx_timer_host = nullptr;
+    return TX_SUCCESS;
+}
+
+UINT threadx::native::_tx_timer_activate(TX_TIMER *timer_ptr)
+{
+    kernel_lock lock(kernel());
+    if (host(timer_ptr)->active)
+    {
+        return TX_ACTIVATE_ERROR;
+    }
+    timers().insert(timer_ptr, timer_ptr->tx_timer_internal.tx_timer_internal_remaining_ticks);
+    return TX_SUCCESS;
+}
+
+UINT threadx::native::_tx_timer_change(TX_TIMER *timer_ptr, ULONG initial_ticks, ULONG reschedule_ticks)
+{
+    if (initial_ticks == 0)
+    {
+        return TX_TICK_ERROR;
+    }
+    kernel_lock lock(kernel());
+    timer_ptr->tx_timer_internal.tx_timer_internal_remaining_ticks = initial_ticks;
+    timer_ptr->tx_timer_internal.tx_timer_internal_re_initialize_ticks = reschedule_ticks;
+    return TX_SUCCESS;
+}
+
+UINT threadx::native::_tx_timer_deactivate(TX_TIMER *timer_ptr)
+{
+    kernel_lock lock(kernel());
+    if (host(timer_ptr)->active)
+    {
+        timers().remove(timer_ptr);
+    }
+    return TX_SUCCESS;
+}
@@ -0,0 +1,122 @@
+/**
+ * @file      ceiling_mutex.h
+ * @brief     Priority ceiling mutex
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __THREADX_CEILING_MUTEX_H_
+#define __THREADX_CEILING_MUTEX_H_
+
+#include "threadx/thread.h"
+#ifdef TX_THREAD_SMP_MAX_CORES
+#include "threadx/mutex.h"
+#endif
+
+namespace threadx
+{
+    namespace native
+    {
+        #ifdef TX_DISABLE_PREEMPTION_THRESHOLD
+        constexpr bool PREEMPTION_THRESHOLD_SUPPORT = false;
+        #else
+        constexpr bool PREEMPTION_THRESHOLD_SUPPORT = true;
+        #endif
+    }
+
+    namespace detail
+    {
+        /// @brief  The non-template part of @ref ceiling_mutex.
+        class ceiling_lock
+        {
+        protected:
+            void lock(thread::priority ceiling);
+            bool try_lock(thread::priority ceiling);
+            void unlock();
+
+            ceiling_lock()
+                : previous_threshold_(0)
+            {
+            }
+
+        private:
+            thread::priority::value_type previous_threshold_;
+        #ifdef TX_THREAD_SMP_MAX_CORES
+            // the preemption threshold only protects against the threads on the same core
+            mutex mutex_;
+        #endif
+        };
+    }
+
+    /// @brief  A mutex implementing the immediate priority ceiling protocol:
+    ///         the owner thread's preemption threshold is raised to the ceiling priority
+    ///         while it holds the lock, so no other user of the mutex can run and contend for it.
+    ///         On a single core no kernel object is needed, and locking never blocks.
+    /// @tparam CEILING: the priority of the most urgent thread using the mutex
+    /// @note   The threads using the mutex must not suspend while holding it,
+    ///         and nested ceiling mutexes must be unlocked in the reverse order of locking.
+    template<thread::priority::value_type CEILING>
+    class ceiling_mutex : private detail::ceiling_lock
+    {
+        static_assert(native::PREEMPTION_THRESHOLD_SUPPORT,
+                "The ceiling mutex requires preemption threshold support, remove TX_DISABLE_PREEMPTION_THRESHOLD.");
+
+    public:
+        /// @brief  The priority ceiling of the mutex.
+        static constexpr thread::priority ceiling()
+        {
+            return CEILING;
+        }
+
+        /// @brief  Locks the mutex, raising the calling thread's preemption threshold to the ceiling.
+        /// @remark Thread context callable
+        inline void lock()
+        {
+            ceiling_lock::lock(CEILING);
+        }
+
+        /// @brief  Tries to lock the mutex, which is always available on a single core.
+        ///         On SMP ports it may be owned by a thread running on another core.
+        /// @return true if the lock is acquired, false if it's owned by another thread
+        /// @remark Thread context callable
+        inline bool try_lock()
+        {
+            return ceiling_lock::try_lock(CEILING);
+        }
+
+        /// @brief  Unlocks the mutex, restoring the calling thread's preemption threshold.
+        /// @remark Thread context callable
+        inline void unlock()
+        {
+            ceiling_lock::unlock();
+        }
+
+        ceiling_mutex()
+        {
+        }
+
+        // non-copyable
+        ceiling_mutex(const ceiling_mutex&) = delete;
+        ceiling_mutex& operator=(const ceiling_mutex&) = delete;
+    };
+}
+
+#endif // __THREADX_CEILING_MUTEX_H_
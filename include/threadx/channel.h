@@ -0,0 +1,366 @@
+/**
+ * @file      channel.h
+ * @brief     ThreadX Go-style channel
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __THREADX_CHANNEL_H_
+#define __THREADX_CHANNEL_H_
+
+#include <atomic>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "threadx/mutex.h"
+#include "threadx/semaphore.h"
+
+namespace threadx
+{
+    namespace detail
+    {
+        /// @brief  Buffered channels return from send as soon as the value is stored.
+        template<bool RENDEZVOUS>
+        class channel_handshake
+        {
+        protected:
+            inline bool wait_received()
+            {
+                return true;
+            }
+            inline void signal_received(bool received)
+            {
+                (void)received;
+            }
+        };
+
+        /// @brief  Unbuffered channels return from send once the receiver took the value.
+        ///         The senders pass the handoff slot on to each other only after the handshake,
+        ///         so a single sender waits for the signal at a time.
+        template<>
+        class channel_handshake<true>
+        {
+        protected:
+            inline bool wait_received()
+            {
+                received_.acquire();
+                return delivered_;
+            }
+            inline void signal_received(bool received)
+            {
+                delivered_ = received;
+                received_.release();
+            }
+
+        private:
+            binary_semaphore received_;
+            bool delivered_ = false;
+        };
+    }
+
+    /// @brief  A Go-style channel for passing values between threads.
+    ///         Buffered channels (N > 0) block only when the buffer is full or empty,
+    ///         unbuffered (N = 0) channels block the sender until the value is received.
+    /// @note   Following the Go convention, @ref close should be called by the sending side,
+    ///         the sends in progress fail when the channel is closed.
+    template<typename T, const std::size_t N>
+    class channel : private detail::channel_handshake<N == 0>
+    {
+        static constexpr std::size_t SLOTS = (N > 0) ? N : 1;
+
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+
+        /// @brief  The number of values the channel can hold without a receiver.
+        static constexpr size_type capacity()
+        {
+            return N;
+        }
+
+        /// @brief  Sends a value through the channel, blocks while the channel is full.
+        /// @param  value: the value to copy into the channel
+        /// @return true if the value is sent, false if the channel is closed
+        inline bool send(const T& value)
+        {
+            return emplace(value);
+        }
+
+        /// @brief  Sends a value through the channel, blocks while the channel is full.
+        /// @param  value: the value to move into the channel
+        /// @return true if the value is sent, false if the channel is closed
+        inline bool send(T&& value)
+        {
+            return emplace(std::move(value));
+        }
+
+        /// @brief  Constructs a value in place in the channel, blocks while the channel is full.
+        /// @param  args: the arguments to construct the value with
+        /// @return true if the value is sent, false if the channel is closed
+        template<typename... Args>
+        bool emplace(Args&&... args)
+        {
+            if (is_closed())
+            {
+                return false;
+            }
+            spaces_.acquire();
+            {
+                lock_guard<mutex> lock(mutex_);
+                if (closed_)
+                {
+                    spaces_.release();
+                    return false;
+                }
+                new (&slots_[tail_]) T(std::forward<Args>(args)...);
+                tail_ = (tail_ + 1) % SLOTS;
+                count_++;
+            }
+            items_.release();
+            const bool received = this->wait_received();
+            if (N == 0)
+            {
+                // the handshake is over, the next sender may take the handoff slot
+                spaces_.release();
+            }
+            return received;
+        }
+
+        /// @brief  Receives a value from the channel, blocks while the channel is empty.
+        /// @param  value: the destination to move the received value to
+        /// @return true if a value is received, false if the channel is closed and drained
+        inline bool receive(T& value)
+        {
+            return get([&value](T& slot) { value = std::move(slot); }, infinity);
+        }
+
+        /// @brief  Tries to receive a value from the channel within the given time duration.
+        /// @param  value:    the destination to move the received value to
+        /// @param  rel_time: duration to wait for a value to arrive
+        /// @return true if a value is received, false if timed out or the channel is closed and drained
+        template<class Rep, class Period>
+        inline bool try_receive_for(T& value, const std::chrono::duration<Rep, Period>& rel_time)
+        {
+            return get([&value](T& slot) { value = std::move(slot); },
+                    std::chrono::duration_cast<tick_timer::duration>(rel_time));
+        }
+
+        /// @brief  Closes the channel: further and blocked sends fail, and receivers
+        ///         are released once the remaining values are drained.
+        ///         On unbuffered channels the value that isn't received yet is withdrawn,
+        ///         and its send fails.
+        void close()
+        {
+            bool withdrawn = false;
+            {
+                lock_guard<mutex> lock(mutex_);
+                closed_ = true;
+                if ((N == 0) && (count_ > 0))
+                {
+                    pop();
+                    withdrawn = true;
+                }
+            }
+            if (withdrawn)
+            {
+                this->signal_received(false);
+            }
+            // a single wakeup is passed on by each receiver finding the channel drained,
+            // and by each sender finding the channel closed
+            items_.release();
+            spaces_.release();
+        }
+
+        /// @brief  Checks whether the channel is closed.
+        /// @return true if @ref close has been called, false otherwise
+        bool is_closed() const
+        {
+            return closed_;
+        }
+
+        /// @brief  Input iterator that receives the channel's values until it is closed.
+        class iterator
+        {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = T*;
+            using reference = T&;
+
+            T& operator*()
+            {
+                return *reinterpret_cast<T*>(&value_);
+            }
+            T* operator->()
+            {
+                return reinterpret_cast<T*>(&value_);
+            }
+            iterator& operator++()
+            {
+                receive();
+                return *this;
+            }
+            bool operator==(const iterator& other) const
+            {
+                return ch_ == other.ch_;
+            }
+            bool operator!=(const iterator& other) const
+            {
+                return ch_ != other.ch_;
+            }
+
+            iterator(iterator&& other)
+                : ch_(other.ch_)
+            {
+                if (ch_ != nullptr)
+                {
+                    new (&value_) T(std::move(*other));
+                }
+            }
+            ~iterator()
+            {
+                if (ch_ != nullptr)
+                {
+                    (**this).~T();
+                }
+            }
+
+            // non-copyable
+            iterator(const iterator&) = delete;
+            iterator& operator=(const iterator&) = delete;
+
+        private:
+            friend class channel;
+
+            iterator(channel *ch = nullptr)
+                : ch_(nullptr)
+            {
+                if (ch != nullptr)
+                {
+                    receive(ch);
+                }
+            }
+
+            void receive(channel *ch)
+            {
+                if (ch->get([this](T& slot) { new (&value_) T(std::move(slot)); }, infinity))
+                {
+                    ch_ = ch;
+                }
+            }
+            void receive()
+            {
+                auto *ch = ch_;
+                (**this).~T();
+                ch_ = nullptr;
+                receive(ch);
+            }
+
+            channel *ch_;
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type value_;
+        };
+
+        /// @brief  Receives the first value from the channel.
+        /// @return Iterator to the received value, or @ref end if the channel is closed and drained
+        iterator begin()
+        {
+            return iterator(this);
+        }
+
+        /// @brief  The iterator marking that the channel is closed and drained.
+        iterator end()
+        {
+            return iterator();
+        }
+
+        /// @brief  Constructs an open, empty channel.
+        channel()
+            : spaces_(SLOTS), items_(0)
+        {
+        }
+
+        /// @brief  Destroys the values that haven't been received.
+        ~channel()
+        {
+            while (count_ > 0)
+            {
+                pop();
+            }
+        }
+
+        // non-copyable
+        channel(const channel&) = delete;
+        channel& operator=(const channel&) = delete;
+
+    private:
+        template<class Consume>
+        bool get(Consume consume, tick_timer::duration timeout)
+        {
+            if (!items_.try_acquire_for(timeout))
+            {
+                return false;
+            }
+            bool received = false;
+            {
+                lock_guard<mutex> lock(mutex_);
+                if (count_ > 0)
+                {
+                    consume(*reinterpret_cast<T*>(&slots_[head_]));
+                    pop();
+                    received = true;
+                }
+            }
+            if (received)
+            {
+                if (N > 0)
+                {
+                    spaces_.release();
+                }
+                this->signal_received(true);
+            }
+            else
+            {
+                // closed and drained, wake up the next waiting receiver
+                items_.release();
+            }
+            return received;
+        }
+
+        void pop()
+        {
+            reinterpret_cast<T*>(&slots_[head_])->~T();
+            head_ = (head_ + 1) % SLOTS;
+            count_--;
+        }
+
+        mutex mutex_;
+        counting_semaphore<SLOTS> spaces_;
+        counting_semaphore<SLOTS> items_;
+        std::size_t head_ = 0;
+        std::size_t tail_ = 0;
+        std::size_t count_ = 0;
+        std::atomic<bool> closed_ { false };
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type slots_[SLOTS];
+    };
+}
+
+#endif // __THREADX_CHANNEL_H_
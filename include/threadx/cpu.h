@@ -33,6 +33,12 @@ namespace threadx
     namespace native
     {
         #include "tx_api.h"
+
+        #ifdef TX_THREAD_SMP_MAX_CORES
+        constexpr UINT CORE_COUNT = TX_THREAD_SMP_MAX_CORES;
+        #else
+        constexpr UINT CORE_COUNT = 1;
+        #endif
     }
 
     class cpu
@@ -43,7 +49,15 @@ namespace threadx
         class critical_section
         {
         public:
+        #ifdef THREADX_MCPP_CRITICAL_SECTION_STATS
+            /// @brief  Constructs a critical section, recording the location of its definition,
+            ///         which identifies it in the statistics regardless of the lock wrapper used.
+            /// @param  file: the source file of the definition, nullptr excludes it from the statistics
+            /// @param  line: the source line of the definition
+            critical_section(const char *file = __builtin_FILE(), unsigned line = __builtin_LINE());
+        #else
             critical_section();
+        #endif
 
             /// @brief  Locks the CPU, preventing thread and interrupt switches.
             void lock();
@@ -52,8 +66,34 @@ namespace threadx
             ///         to preempt the current execution context.
             void unlock();
 
+        #ifdef THREADX_MCPP_CRITICAL_SECTION_STATS
+            /// @brief  The interrupt masking statistics of a critical section's definition site,
+            ///         measured by @ref this_cpu::get_timestamp from the outermost lock to its unlock.
+            struct site_statistics
+            {
+                const char *file;       ///< the source file of the critical section
+                unsigned line;          ///< the source line of the critical section
+                native::ULONG count;    ///< the number of lock calls
+                native::ULONG max;      ///< the longest masked duration
+                native::ULONG total;    ///< the sum of the masked durations
+            };
+
+            /// @brief  Collects the call sites with the longest interrupt masked durations.
+            /// @param  sites: the destination array of the worst offenders
+            /// @param  max:   the size of the destination array
+            /// @return The number of reported call sites, in descending order of their longest duration
+            static std::size_t get_worst_sites(site_statistics *sites, std::size_t max);
+
+            /// @brief  Clears the collected statistics.
+            static void reset_statistics();
+        #endif // THREADX_MCPP_CRITICAL_SECTION_STATS
+
         private:
             TX_INTERRUPT_SAVE_AREA
+        #ifdef THREADX_MCPP_CRITICAL_SECTION_STATS
+            const char *file_;
+            unsigned line_;
+        #endif
         };
     };
 
@@ -63,6 +103,18 @@ namespace threadx
         ///         an interrupt service routine.
         /// @return true if the current execution context is ISR, false otherwise
         bool is_in_isr();
+
+        /// @brief  Reads the high resolution time source of the CPU, which is the
+        ///         TX_TRACE_TIME_SOURCE of the port if available (e.g. the cycle counter),
+        ///         or the tick count otherwise.
+        /// @return The current timestamp, which wraps around on overflow
+        /// @remark Thread and ISR context callable
+        native::ULONG get_timestamp();
+
+        /// @brief  Determines the index of the executing CPU core.
+        /// @return The current core's index, below native::CORE_COUNT
+        /// @remark Thread and ISR context callable
+        native::UINT get_core_id();
     }
 }
 
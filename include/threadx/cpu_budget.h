@@ -0,0 +1,136 @@
+/**
+ * @file      cpu_budget.h
+ * @brief     CPU time budget enforcement
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __THREADX_CPU_BUDGET_H_
+#define __THREADX_CPU_BUDGET_H_
+
+#include "threadx/thread.h"
+#include "threadx/wait_queue.h"
+
+namespace threadx
+{
+    /// @brief  A CPU time budget shared by a group of threads, which is replenished periodically.
+    ///         The execution time is accounted in ticks, by calling @ref on_tick from the tick interrupt.
+    ///         The threads of a group that exhausted its budget are throttled until the next replenishment.
+    /// @note   The enforcement is performed by ThreadX timers, so TX_TIMER_PROCESS_IN_ISR must not be defined.
+    class cpu_budget
+    {
+    public:
+        /// @brief  The action taken against the threads of an exhausted group.
+        enum class policy
+        {
+            suspend,    ///< the threads are suspended
+            demote,     ///< the threads run at the demoted priority
+        };
+
+        /// @brief  The membership of a thread in a budget group.
+        class member
+        {
+        public:
+            /// @brief  Adds a thread to the budget group.
+            /// @param  group: the budget group to charge the thread's execution to
+            /// @param  t:     the member thread
+            /// @note   When the calling thread joins a throttled group, it's throttled right away,
+            ///         under the suspend policy this returns once the budget is replenished.
+            member(cpu_budget& group, thread& t);
+
+            /// @brief  Removes the thread from the budget group, lifting its throttling.
+            /// @note   Waits for the group's ongoing throttling or release to finish.
+            ~member();
+
+            // non-copyable
+            member(const member&) = delete;
+            member& operator=(const member&) = delete;
+
+        private:
+            friend class cpu_budget;
+
+            cpu_budget& group_;
+            thread& thread_;
+            member *next_;
+            thread::priority saved_priority_;
+            bool throttled_;
+            bool parked_;
+        };
+
+        /// @brief  Charges the current tick to the budget of the interrupted thread's group,
+        ///         to be called from the application's tick interrupt handler.
+        /// @remark ISR context callable
+        static void on_tick();
+
+        /// @brief  Function to observe the budget consumed in the current period.
+        tick_timer::duration get_used() const
+        {
+            return tick_timer::duration(used_);
+        }
+
+        /// @brief  Checks if the threads of the group are currently throttled.
+        bool is_throttled() const
+        {
+            return throttled_;
+        }
+
+        /// @brief  Creates a budget group, and starts its replenishment period.
+        /// @param  budget:   the execution time allowed in each period
+        /// @param  period:   the replenishment period of the budget
+        /// @param  p:        the action taken against the threads when the budget is exhausted
+        /// @param  demoted:  the priority of the throttled threads when demoting, the lowest by default
+        cpu_budget(tick_timer::duration budget, tick_timer::duration period,
+                policy p = policy::suspend, thread::priority demoted = native::TOP_PRIORITY - 1);
+
+        /// @brief  Stops the budget enforcement.
+        ~cpu_budget();
+
+        // non-copyable
+        cpu_budget(const cpu_budget&) = delete;
+        cpu_budget& operator=(const cpu_budget&) = delete;
+
+    private:
+        static void replenish_callback(native::ULONG param);
+        static void enforce_callback(native::ULONG param);
+
+        void add(member& m);
+        void remove(member& m);
+        void charge();
+        void update();
+        void throttle(member& m);
+        void release(member& m);
+        void park(member& m, wait_queue::lock_type& lock);
+
+        native::TX_TIMER replenish_timer_;
+        native::TX_TIMER enforce_timer_;
+        cpu_budget *next_;
+        member *members_;
+        const tick_timer::rep budget_;
+        volatile tick_timer::rep used_;
+        volatile bool throttled_;
+        bool updating_;
+        wait_queue updates_;
+        const policy policy_;
+        const thread::priority demoted_;
+    };
+}
+
+#endif // __THREADX_CPU_BUDGET_H_
@@ -0,0 +1,151 @@
+/**
+ * @file      cyclic_executive.h
+ * @brief     Time-triggered cyclic executive
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __THREADX_CYCLIC_EXECUTIVE_H_
+#define __THREADX_CYCLIC_EXECUTIVE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include "threadx/cpu.h"
+#include "threadx/tick_timer.h"
+
+namespace threadx
+{
+    /// @brief  A time-triggered cyclic executive, which dispatches a static table of periodic functions
+    ///         from a single thread, aligned to the ticks of @ref tick_timer.
+    ///         Each table slot is released at its offset, then once every period,
+    ///         the slots released at the same tick run in their table order.
+    ///         The schedule repeats every major frame, the least common multiple of the periods,
+    ///         and all releases of a frame have to complete by the end of the frame.
+    class cyclic_executive
+    {
+    public:
+        using function = void (*)();
+
+        /// @brief  The execution statistics of a slot, the times are measured by @ref this_cpu::get_timestamp.
+        struct statistics
+        {
+            native::ULONG min_time;
+            native::ULONG max_time;
+            std::uint64_t total_time;
+            std::size_t runs;
+            std::size_t overruns;
+        };
+
+        /// @brief  An entry of the schedule table.
+        class slot
+        {
+        public:
+            /// @brief  Function to observe the execution statistics of the slot.
+            /// @return The statistics, which are only consistent when the executive isn't running
+            const statistics& get_statistics() const
+            {
+                return stats_;
+            }
+
+            /// @brief  Resets the execution statistics of the slot.
+            void reset_statistics()
+            {
+                stats_ = statistics { static_cast<native::ULONG>(-1), 0, 0, 0, 0 };
+            }
+
+            /// @brief  Defines a schedule table entry.
+            /// @param  fn:     the function to call
+            /// @param  period: the time between two releases
+            /// @param  offset: the time of the first release, relative to the start of the executive
+            constexpr slot(function fn, tick_timer::duration period,
+                    tick_timer::duration offset = tick_timer::duration(0))
+                : fn_(fn), period_(to_ticks(period)), offset_(to_ticks(offset)), release_(0),
+                  stats_ { static_cast<native::ULONG>(-1), 0, 0, 0, 0 }
+            {
+            }
+
+        private:
+            friend class cyclic_executive;
+
+            function fn_;
+            tick_timer::rep period_;
+            tick_timer::rep offset_;
+            tick_timer::rep release_;
+            statistics stats_;
+        };
+
+        /// @brief  Function that handles a slot completing after its next release time.
+        using overrun_handler = void (*)(const slot& s, tick_timer::duration overrun);
+
+        /// @brief  Dispatches the schedule table continuously,
+        ///         the entry function of the executive thread.
+        /// @note   The executive thread should have the highest priority of the slots' users.
+        [[noreturn]] void run();
+
+        /// @brief  Function to observe the total number of overruns of the schedule.
+        /// @return The sum of the slots' overruns
+        std::size_t get_overruns() const;
+
+        /// @brief  Function to observe the number of major frames
+        ///         whose releases completed after the end of the frame.
+        std::size_t get_frame_overruns() const
+        {
+            return frame_overruns_;
+        }
+
+        /// @brief  Function to observe the length of the major frame.
+        tick_timer::duration get_major_frame() const
+        {
+            return tick_timer::duration(frame_);
+        }
+
+        /// @brief  Creates an executive for a schedule table.
+        /// @param  table:      the schedule table
+        /// @param  on_overrun: optional function to call when a slot overruns
+        template<const std::size_t N>
+        cyclic_executive(slot (&table)[N], overrun_handler on_overrun = nullptr)
+            : cyclic_executive(table, N, on_overrun)
+        {
+        }
+
+        /// @brief  Creates an executive for a schedule table.
+        /// @param  table:      the schedule table
+        /// @param  count:      the number of slots in the table
+        /// @param  on_overrun: optional function to call when a slot overruns
+        cyclic_executive(slot *table, std::size_t count, overrun_handler on_overrun = nullptr);
+
+        // non-copyable
+        cyclic_executive(const cyclic_executive&) = delete;
+        cyclic_executive& operator=(const cyclic_executive&) = delete;
+
+    private:
+        void dispatch(slot& s);
+
+        slot *const table_;
+        const std::size_t count_;
+        const overrun_handler on_overrun_;
+        tick_timer::rep frame_;
+        tick_timer::rep frame_end_;
+        volatile std::size_t frame_overruns_;
+    };
+}
+
+#endif // __THREADX_CYCLIC_EXECUTIVE_H_
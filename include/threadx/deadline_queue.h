@@ -0,0 +1,404 @@
+/**
+ * @file      deadline_queue.h
+ * @brief     Earliest-deadline-first priority queue
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __THREADX_DEADLINE_QUEUE_H_
+#define __THREADX_DEADLINE_QUEUE_H_
+
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "threadx/mutex.h"
+#include "threadx/semaphore.h"
+
+namespace threadx
+{
+    /// @brief  A fixed capacity priority queue of values ordered by their deadline,
+    ///         for earliest-deadline-first dispatching. Insertion, removal and cancellation
+    ///         take O(log N) time, the earliest deadline is available in O(1).
+    /// @note   The deadlines are compared relative to each other, so the tick count
+    ///         may wrap around, as long as the queued deadlines span less than half of its range.
+    template<typename T, const std::size_t N>
+    class deadline_queue
+    {
+        static_assert(N > 0, "The queue must have a capacity.");
+
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using time_point = tick_timer::time_point;
+
+        /// @brief  Identifies a queued value, for cancellation or rescheduling.
+        ///         A handle becomes stale once its value leaves the queue.
+        class handle
+        {
+        public:
+            /// @brief  Checks if the handle was issued by a successful insertion.
+            explicit operator bool() const
+            {
+                return slot_ < N;
+            }
+
+            constexpr handle()
+                : slot_(N), generation_(0)
+            {
+            }
+
+        private:
+            friend class deadline_queue;
+
+            constexpr handle(size_type slot, size_type generation)
+                : slot_(slot), generation_(generation)
+            {
+            }
+
+            size_type slot_;
+            size_type generation_;
+        };
+
+        /// @brief  The maximal number of values the queue can hold.
+        static constexpr size_type capacity()
+        {
+            return N;
+        }
+
+        /// @brief  Inserts a value into the queue.
+        /// @param  value:    the value to copy into the queue
+        /// @param  deadline: the time when the value becomes due
+        /// @return The handle of the queued value, invalid if the queue is full
+        inline handle push(const T& value, time_point deadline)
+        {
+            return emplace(deadline, value);
+        }
+
+        /// @brief  Inserts a value into the queue.
+        /// @param  value:    the value to move into the queue
+        /// @param  deadline: the time when the value becomes due
+        /// @return The handle of the queued value, invalid if the queue is full
+        inline handle push(T&& value, time_point deadline)
+        {
+            return emplace(deadline, std::move(value));
+        }
+
+        /// @brief  Constructs a value in place in the queue.
+        /// @param  deadline: the time when the value becomes due
+        /// @param  args:     the arguments to construct the value with
+        /// @return The handle of the queued value, invalid if the queue is full
+        template<typename... Args>
+        handle emplace(time_point deadline, Args&&... args)
+        {
+            bool earliest;
+            handle h;
+            {
+                lock_guard<mutex> lock(mutex_);
+                if (count_ == N)
+                {
+                    return h;
+                }
+                // the slots past the heap are the free ones
+                size_type slot = heap_[count_];
+                new (&values_[slot]) T(std::forward<Args>(args)...);
+                deadlines_[slot] = deadline;
+                count_++;
+                earliest = sift_up(count_ - 1) == 0;
+                h = handle(slot, generations_[slot]);
+            }
+            if (earliest)
+            {
+                wake();
+            }
+            return h;
+        }
+
+        /// @brief  Removes a value from the queue before it's dispatched.
+        /// @param  h: the handle of the value
+        /// @return true if the value is removed, false if it's no longer in the queue
+        bool cancel(const handle& h)
+        {
+            lock_guard<mutex> lock(mutex_);
+            if (!is_queued(h))
+            {
+                return false;
+            }
+            value_at(h.slot_).~T();
+            remove(positions_[h.slot_]);
+            return true;
+        }
+
+        /// @brief  Changes the deadline of a queued value.
+        /// @param  h:        the handle of the value
+        /// @param  deadline: the new time when the value becomes due
+        /// @return true if the value is rescheduled, false if it's no longer in the queue
+        bool reschedule(const handle& h, time_point deadline)
+        {
+            bool earliest;
+            {
+                lock_guard<mutex> lock(mutex_);
+                if (!is_queued(h))
+                {
+                    return false;
+                }
+                deadlines_[h.slot_] = deadline;
+                earliest = sift_down(sift_up(positions_[h.slot_])) == 0;
+            }
+            if (earliest)
+            {
+                wake();
+            }
+            return true;
+        }
+
+        /// @brief  Removes the value with the earliest deadline, if it's already due.
+        /// @param  value: the destination to move the removed value to
+        /// @return true if a due value is removed, false otherwise
+        inline bool try_pop_due(T& value)
+        {
+            lock_guard<mutex> lock(mutex_);
+            return pop_due(value, nullptr);
+        }
+
+        /// @brief  Waits until the earliest deadline is due, and removes its value.
+        ///         The wait is extended or shortened as values are queued or cancelled.
+        /// @param  value: the destination to move the removed value to
+        /// @note   Only a single thread should wait on the queue at a time.
+        inline void wait_pop_until_due(T& value)
+        {
+            (void)wait_pop(value, infinity);
+        }
+
+        /// @brief  Waits until the earliest deadline is due, and removes its value,
+        ///         or the given time duration passes.
+        /// @param  value:    the destination to move the removed value to
+        /// @param  rel_time: the maximal duration to wait
+        /// @return true if a due value is removed, false if timed out
+        /// @note   Only a single thread should wait on the queue at a time.
+        template<class Rep, class Period>
+        inline bool wait_pop_until_due_for(T& value, const std::chrono::duration<Rep, Period>& rel_time)
+        {
+            return wait_pop(value, std::chrono::duration_cast<tick_timer::duration>(rel_time));
+        }
+
+        /// @brief  Function to observe the earliest deadline in the queue.
+        /// @param  deadline: the destination of the earliest deadline
+        /// @return true if the queue isn't empty, false otherwise
+        bool next_deadline(time_point& deadline)
+        {
+            lock_guard<mutex> lock(mutex_);
+            if (count_ == 0)
+            {
+                return false;
+            }
+            deadline = deadlines_[heap_[0]];
+            return true;
+        }
+
+        /// @brief  Function to observe the number of queued values.
+        size_type size() const
+        {
+            return count_;
+        }
+
+        /// @brief  Checks if the queue is empty.
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        /// @brief  Constructs an empty queue.
+        deadline_queue()
+            : count_(0)
+        {
+            for (size_type i = 0; i < N; i++)
+            {
+                heap_[i] = i;
+                positions_[i] = i;
+                generations_[i] = 0;
+            }
+        }
+
+        /// @brief  Destroys the values remaining in the queue.
+        ~deadline_queue()
+        {
+            for (size_type i = 0; i < count_; i++)
+            {
+                value_at(heap_[i]).~T();
+            }
+        }
+
+        // non-copyable
+        deadline_queue(const deadline_queue&) = delete;
+        deadline_queue& operator=(const deadline_queue&) = delete;
+
+    private:
+        using signed_rep = typename std::make_signed<tick_timer::rep>::type;
+
+        // the signed distance of the two time points, robust to the tick count wrapping around
+        static signed_rep distance(time_point from, time_point to)
+        {
+            return static_cast<signed_rep>(to_ticks(to) - to_ticks(from));
+        }
+
+        inline bool earlier(size_type pos_a, size_type pos_b) const
+        {
+            return distance(deadlines_[heap_[pos_b]], deadlines_[heap_[pos_a]]) < 0;
+        }
+
+        inline T& value_at(size_type slot)
+        {
+            return *reinterpret_cast<T*>(&values_[slot]);
+        }
+
+        inline bool is_queued(const handle& h) const
+        {
+            return h && (positions_[h.slot_] < count_) && (generations_[h.slot_] == h.generation_);
+        }
+
+        inline void swap(size_type pos_a, size_type pos_b)
+        {
+            std::swap(heap_[pos_a], heap_[pos_b]);
+            positions_[heap_[pos_a]] = pos_a;
+            positions_[heap_[pos_b]] = pos_b;
+        }
+
+        size_type sift_up(size_type pos)
+        {
+            while ((pos > 0) && earlier(pos, (pos - 1) / 2))
+            {
+                swap(pos, (pos - 1) / 2);
+                pos = (pos - 1) / 2;
+            }
+            return pos;
+        }
+
+        size_type sift_down(size_type pos)
+        {
+            while (true)
+            {
+                size_type first = pos;
+                size_type child = 2 * pos + 1;
+                if ((child < count_) && earlier(child, first))
+                {
+                    first = child;
+                }
+                child++;
+                if ((child < count_) && earlier(child, first))
+                {
+                    first = child;
+                }
+                if (first == pos)
+                {
+                    return pos;
+                }
+                swap(pos, first);
+                pos = first;
+            }
+        }
+
+        // the value at the position is already destroyed or moved from,
+        // its slot is moved past the heap, freeing it up
+        void remove(size_type pos)
+        {
+            size_type slot = heap_[pos];
+            generations_[slot]++;
+            count_--;
+            if (pos != count_)
+            {
+                swap(pos, count_);
+                (void)sift_down(sift_up(pos));
+            }
+        }
+
+        bool pop_due(T& value, tick_timer::duration *remaining)
+        {
+            if (count_ == 0)
+            {
+                return false;
+            }
+            size_type slot = heap_[0];
+            signed_rep until_due = distance(tick_timer::now(), deadlines_[slot]);
+            if (until_due > 0)
+            {
+                if (remaining != nullptr)
+                {
+                    *remaining = tick_timer::duration(static_cast<tick_timer::rep>(until_due));
+                }
+                return false;
+            }
+            value = std::move(value_at(slot));
+            value_at(slot).~T();
+            remove(0);
+            return true;
+        }
+
+        inline void wake()
+        {
+            // the wakeup is only a hint, the waiter rechecks the earliest deadline itself
+            if (wakeup_.get_count() == 0)
+            {
+                wakeup_.release();
+            }
+        }
+
+        bool wait_pop(T& value, tick_timer::duration timeout)
+        {
+            const auto start = tick_timer::now();
+            while (true)
+            {
+                auto remaining = infinity;
+                {
+                    lock_guard<mutex> lock(mutex_);
+                    if (pop_due(value, &remaining))
+                    {
+                        return true;
+                    }
+                }
+                if (timeout != infinity)
+                {
+                    const auto elapsed = tick_timer::now() - start;
+                    if (elapsed >= timeout)
+                    {
+                        return false;
+                    }
+                    if ((timeout - elapsed) < remaining)
+                    {
+                        remaining = timeout - elapsed;
+                    }
+                }
+                // woken early when an earlier deadline is queued
+                (void)wakeup_.try_acquire_for(remaining);
+            }
+        }
+
+        mutex mutex_;
+        binary_semaphore wakeup_;
+        size_type count_;
+        size_type heap_[N];
+        size_type positions_[N];
+        size_type generations_[N];
+        time_point deadlines_[N];
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type values_[N];
+    };
+}
+
+#endif // __THREADX_DEADLINE_QUEUE_H_
@@ -0,0 +1,145 @@
+/**
+ * @file      deferred_log.h
+ * @brief     Deferred binary logging
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __THREADX_DEFERRED_LOG_H_
+#define __THREADX_DEFERRED_LOG_H_
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "threadx/cpu.h"
+
+/// @brief  Logs a printf-style message, deferring its formatting to the host.
+///         The format string is placed in the .threadx_log section, which can be kept out of
+///         the target's memory with an (INFO) output section in the linker script,
+///         only its address is recorded together with the raw arguments.
+/// @param  FORMAT: the string literal format of the message
+/// @remark Thread and ISR context callable
+#define THREADX_LOG(FORMAT, ...)                                                    \
+    do {                                                                            \
+        __attribute__((section(".threadx_log"), used))                              \
+        static const char threadx_log_format_[] = FORMAT;                           \
+        threadx::deferred_log::write(threadx_log_format_, ##__VA_ARGS__);           \
+    } while (false)
+
+namespace threadx
+{
+    namespace detail
+    {
+        using log_word = std::uint32_t;
+
+        /// @brief  The arguments are recorded as passed through printf's variadic arguments.
+        template<typename T>
+        struct log_arg
+        {
+            using type = typename std::conditional<std::is_floating_point<T>::value, double,
+                         typename std::conditional<std::is_integral<T>::value && (sizeof(T) < sizeof(int)), int,
+                         T>::type>::type;
+            static constexpr std::size_t words = (sizeof(type) + sizeof(log_word) - 1) / sizeof(log_word);
+        };
+
+        constexpr std::size_t log_words()
+        {
+            return 0;
+        }
+
+        template<typename T, typename... Ts>
+        constexpr std::size_t log_words(T, Ts... args)
+        {
+            return log_arg<T>::words + log_words(args...);
+        }
+
+        inline void log_encode(log_word*)
+        {
+        }
+
+        template<typename T, typename... Ts>
+        inline void log_encode(log_word *words, T arg, Ts... args)
+        {
+            static_assert(std::is_scalar<T>::value, "Only scalar values can be logged.");
+            const typename log_arg<T>::type value = arg;
+            words[log_arg<T>::words - 1] = 0;
+            std::memcpy(words, &value, sizeof(value));
+            log_encode(words + log_arg<T>::words, args...);
+        }
+    }
+
+    /// @brief  A binary logging facility for thread and ISR contexts alike.
+    ///         Each record holds the format string's address, a @ref this_cpu::get_timestamp,
+    ///         the logging thread's id (0 in ISR context) and the raw arguments in the target's
+    ///         native layout, and is written to a lock-free ring buffer. The records are shipped
+    ///         by @ref drain, and formatted by the host (tools/log_decode.py).
+    class deferred_log
+    {
+    public:
+        using word = detail::log_word;
+
+        /// @brief  The number of words holding an address or a thread id in a record.
+        static constexpr std::size_t POINTER_WORDS = detail::log_arg<std::uintptr_t>::words;
+
+        /// @brief  The number of header words preceding the arguments in each record:
+        ///         the record's size, the format string's address, the timestamp and the thread id.
+        static constexpr std::size_t HEADER_WORDS = 2 + 2 * POINTER_WORDS;
+
+        /// @brief  The maximal number of argument words in a record.
+        static constexpr std::size_t MAX_ARG_WORDS = 12;
+
+        /// @brief  Function that ships a record, e.g. to a UART or a file.
+        using sink = void (*)(const word *record, std::size_t count);
+
+        /// @brief  Records a message. Use @ref THREADX_LOG instead, which provides
+        ///         the format string from the dedicated section.
+        /// @param  format: the format string, whose address identifies the message
+        /// @param  args:   the scalar arguments of the message
+        /// @return true if recorded, false if the buffer is full and the record is dropped
+        /// @remark Thread and ISR context callable
+        template<typename... Args>
+        static bool write(const char *format, Args... args)
+        {
+            constexpr std::size_t count = detail::log_words(Args()...);
+            static_assert(count <= MAX_ARG_WORDS, "Too many arguments in a log record.");
+
+            word words[(count > 0) ? count : 1];
+            detail::log_encode(words, args...);
+            return commit(format, words, count);
+        }
+
+        /// @brief  Ships the completed records to the sink, in the order of their recording.
+        ///         The records are preceded by a stream header record, which describes
+        ///         the byte order and the size of the target's pointers and longs.
+        /// @param  s: the destination of the records
+        /// @return The number of shipped records
+        /// @note   Only a single thread should drain the log, typically at a low priority.
+        static std::size_t drain(sink s);
+
+        /// @brief  Function to observe the number of dropped records.
+        static std::size_t get_dropped();
+
+    private:
+        static bool commit(const char *format, const word *args, std::size_t count);
+    };
+}
+
+#endif // __THREADX_DEFERRED_LOG_H_
@@ -0,0 +1,116 @@
+/**
+ * @file      footprint.h
+ * @brief     ThreadX compile-time RAM footprint calculator
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __THREADX_FOOTPRINT_H_
+#define __THREADX_FOOTPRINT_H_
+
+#include <cstddef>
+#include <type_traits>
+
+namespace threadx
+{
+    namespace detail
+    {
+        template<class T>
+        struct has_stack
+        {
+            template<class U>
+            static std::true_type test(decltype(U::STACK_SIZE)*);
+            template<class U>
+            static std::false_type test(...);
+
+            static constexpr bool value = decltype(test<T>(nullptr))::value;
+        };
+
+        template<class T, bool = has_stack<T>::value>
+        struct stack_size : std::integral_constant<std::size_t, T::STACK_SIZE>
+        {
+        };
+
+        template<class T>
+        struct stack_size<T, false> : std::integral_constant<std::size_t, 0>
+        {
+        };
+    }
+
+    /// @brief  Compile-time RAM footprint of library objects, e.g. of an application's
+    ///         static kernel objects: footprint<static_thread<1024>, mutex, semaphore[4]>
+    template<class... Ts>
+    struct footprint;
+
+    template<>
+    struct footprint<>
+    {
+        /// @brief  The total size of the objects in bytes.
+        static constexpr std::size_t value = 0;
+
+        /// @brief  The size of the statically allocated thread stacks within the total.
+        static constexpr std::size_t stack = 0;
+
+        /// @brief  The size of the kernel control blocks and wrapper state within the total.
+        static constexpr std::size_t control = value - stack;
+    };
+
+    template<class T>
+    struct footprint<T>
+    {
+        static constexpr std::size_t value = sizeof(T);
+        static constexpr std::size_t stack = detail::stack_size<T>::value;
+        static constexpr std::size_t control = value - stack;
+    };
+
+    template<class T, std::size_t N>
+    struct footprint<T[N]>
+    {
+        static constexpr std::size_t value = N * footprint<T>::value;
+        static constexpr std::size_t stack = N * footprint<T>::stack;
+        static constexpr std::size_t control = value - stack;
+    };
+
+    template<class T, class... Ts>
+    struct footprint<T, Ts...>
+    {
+        static constexpr std::size_t value = footprint<T>::value + footprint<Ts...>::value;
+        static constexpr std::size_t stack = footprint<T>::stack + footprint<Ts...>::stack;
+        static constexpr std::size_t control = value - stack;
+    };
+
+    /// @brief  Compile-time check of the objects' RAM footprint against a budget.
+    ///         Instantiating it fails the build when the objects don't fit:
+    ///         static_assert(ram_budget<16 * 1024, static_thread<1024>, mutex>::value, "");
+    template<std::size_t LIMIT, class... Ts>
+    struct ram_budget
+    {
+        static_assert(footprint<Ts...>::value <= LIMIT, "the objects exceed the RAM budget");
+
+        /// @brief  Always true, the instantiation itself performs the check.
+        static constexpr bool value = true;
+
+        /// @brief  The unused part of the budget in bytes.
+        static constexpr std::size_t remaining = LIMIT - footprint<Ts...>::value;
+    };
+}
+
+#endif // __THREADX_FOOTPRINT_H_
@@ -0,0 +1,156 @@
+/**
+ * @file      io_completion_port.h
+ * @brief     Asynchronous I/O completion port
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __THREADX_IO_COMPLETION_PORT_H_
+#define __THREADX_IO_COMPLETION_PORT_H_
+
+#include <cstddef>
+#include "threadx/wait_queue.h"
+
+namespace threadx
+{
+    class io_completion_port;
+
+    /// @brief  The base class of asynchronous I/O requests. Drivers derive their requests from it,
+    ///         and the completion handler can access the request through a downcast.
+    class io_operation
+    {
+    public:
+        using result_type = std::ptrdiff_t;
+        using handler_type = void (*)(io_operation& op);
+
+        /// @brief  Checks if the operation is submitted, and it isn't reaped yet.
+        bool is_pending() const
+        {
+            return pending_;
+        }
+
+        /// @brief  Function to observe the result of the completed operation.
+        /// @return The result that the driver completed the operation with
+        result_type get_result() const
+        {
+            return result_;
+        }
+
+        /// @brief  Constructs an idle operation.
+        /// @param  handler: the function to call by the reaping thread once the operation completes
+        constexpr io_operation(handler_type handler)
+            : handler_(handler), next_(nullptr), result_(0), pending_(false)
+        {
+        }
+
+        // non-copyable
+        io_operation(const io_operation&) = delete;
+        io_operation& operator=(const io_operation&) = delete;
+
+    private:
+        friend class io_completion_port;
+
+        handler_type handler_;
+        io_operation *next_;
+        result_type result_;
+        volatile bool pending_;
+    };
+
+    /// @brief  An I/O completion port multiplexes the completions of many outstanding
+    ///         asynchronous operations over a few reaping threads. Operations are completed
+    ///         from the drivers' ISRs, and the completions are reaped in batches.
+    class io_completion_port
+    {
+    public:
+        using result_type = io_operation::result_type;
+
+        /// @brief  Marks the operation as outstanding on this port,
+        ///         to be called before the driver starts the operation.
+        /// @param  op: the operation to submit
+        /// @remark Thread and ISR context callable
+        void submit(io_operation& op);
+
+        /// @brief  Posts the completion of a submitted operation, waking a reaping thread.
+        /// @param  op:     the completed operation
+        /// @param  result: the result of the operation
+        /// @remark Thread and ISR context callable
+        void complete(io_operation& op, result_type result);
+
+        /// @brief  Waits until at least one completion is posted, and takes out a batch of completions.
+        /// @param  ops: the destination array of the completed operations
+        /// @param  max: the size of the destination array
+        /// @return The number of reaped operations
+        inline std::size_t reap(io_operation *ops[], std::size_t max)
+        {
+            return get(ops, max, infinity);
+        }
+
+        /// @brief  Waits until at least one completion is posted, or the given time duration passes,
+        ///         and takes out a batch of completions.
+        /// @param  ops:      the destination array of the completed operations
+        /// @param  max:      the size of the destination array
+        /// @param  rel_time: the maximal duration to wait
+        /// @return The number of reaped operations, 0 if timed out
+        template<class Rep, class Period>
+        inline std::size_t reap_for(io_operation *ops[], std::size_t max,
+                const std::chrono::duration<Rep, Period>& rel_time)
+        {
+            return get(ops, max, std::chrono::duration_cast<tick_timer::duration>(rel_time));
+        }
+
+        /// @brief  Reaps a batch of completions, and calls their completion handlers.
+        /// @param  max: the maximal number of completions to handle
+        /// @return The number of handled completions
+        std::size_t dispatch(std::size_t max);
+
+        /// @brief  Handles the completions of the port continuously,
+        ///         the entry function of the reaping threads.
+        /// @param  batch: the maximal number of completions to reap at once
+        [[noreturn]] void serve(std::size_t batch = 8);
+
+        /// @brief  Function to observe the number of submitted operations, which aren't reaped yet.
+        std::size_t get_outstanding() const
+        {
+            return outstanding_;
+        }
+
+        /// @brief  Constructs an idle completion port.
+        constexpr io_completion_port()
+            : head_(nullptr), tail_(nullptr), outstanding_(0), reapers_()
+        {
+        }
+
+        // non-copyable
+        io_completion_port(const io_completion_port&) = delete;
+        io_completion_port& operator=(const io_completion_port&) = delete;
+
+    private:
+        io_operation *take(std::size_t max, tick_timer::duration timeout);
+        std::size_t get(io_operation *ops[], std::size_t max, tick_timer::duration timeout);
+
+        io_operation *head_;
+        io_operation *tail_;
+        volatile std::size_t outstanding_;
+        wait_queue reapers_;
+    };
+}
+
+#endif // __THREADX_IO_COMPLETION_PORT_H_
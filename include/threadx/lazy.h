@@ -0,0 +1,148 @@
+/**
+ * @file      lazy.h
+ * @brief     ThreadX thread-safe lazy initialization
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __THREADX_LAZY_H_
+#define __THREADX_LAZY_H_
+
+#include <atomic>
+#include <new>
+#include <utility>
+
+namespace threadx
+{
+    namespace detail
+    {
+        /// @brief  The states of a one-time initialization.
+        enum once_state : unsigned char
+        {
+            once_uninitialized = 0,
+            once_busy,
+            once_done,
+        };
+
+        /// @brief  Claims the one-time initialization, or waits until
+        ///         the concurrent initialization of another thread is finished.
+        /// @param  state: the state of the initialization
+        /// @return true if the caller has to perform the initialization, false if it's already done
+        bool once_begin(std::atomic<unsigned char>& state);
+
+        /// @brief  Finishes the one-time initialization claimed by @ref once_begin,
+        ///         and wakes up the threads waiting for it.
+        /// @param  state:   the state of the initialization
+        /// @param  success: false if the initialization was abandoned, and may be attempted again
+        void once_end(std::atomic<unsigned char>& state, bool success);
+    }
+
+    /// @brief  A wrapper that constructs the object on first use, safely from
+    ///         competing threads, before or after the scheduler is started.
+    ///         Concurrent users block until the construction is finished,
+    ///         afterwards the access costs a single acquire load.
+    template<typename T>
+    class lazy
+    {
+    public:
+        using value_type = T;
+
+        /// @brief  Accesses the object, constructing it on first use.
+        /// @param  args: the arguments to construct the object with, ignored after construction
+        /// @return Reference to the constructed object
+        template<typename... Args>
+        inline T& get(Args&&... args)
+        {
+            if (state_.load(std::memory_order_acquire) != detail::once_done)
+            {
+                construct(std::forward<Args>(args)...);
+            }
+            return storage_.value;
+        }
+
+        inline T& operator*()
+        {
+            return get();
+        }
+
+        inline T* operator->()
+        {
+            return &get();
+        }
+
+        /// @brief  Checks whether the object is already constructed.
+        /// @return true if the object is constructed, false otherwise
+        /// @remark Thread and ISR context callable
+        bool is_initialized() const
+        {
+            return state_.load(std::memory_order_acquire) == detail::once_done;
+        }
+
+        /// @brief  Constant initialization makes the wrapper usable before any constructors run.
+        constexpr lazy()
+            : state_(detail::once_uninitialized), storage_()
+        {
+        }
+
+        /// @brief  Destroys the object, if it was constructed.
+        ~lazy()
+        {
+            if (is_initialized())
+            {
+                storage_.value.~T();
+            }
+        }
+
+        // non-copyable
+        lazy(const lazy&) = delete;
+        lazy& operator=(const lazy&) = delete;
+
+    private:
+        template<typename... Args>
+        void construct(Args&&... args)
+        {
+            if (detail::once_begin(state_))
+            {
+                new (&storage_.value) T(std::forward<Args>(args)...);
+                detail::once_end(state_, true);
+            }
+        }
+
+        union storage
+        {
+            constexpr storage()
+                : empty()
+            {
+            }
+            ~storage()
+            {
+            }
+
+            unsigned char empty;
+            T value;
+        };
+
+        std::atomic<unsigned char> state_;
+        storage storage_;
+    };
+}
+
+#endif // __THREADX_LAZY_H_
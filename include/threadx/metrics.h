@@ -0,0 +1,258 @@
+/**
+ * @file      metrics.h
+ * @brief     Lock-free metrics registry
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __THREADX_METRICS_H_
+#define __THREADX_METRICS_H_
+
+#include <atomic>
+#include <cstdint>
+#include "threadx/cpu.h"
+
+namespace threadx
+{
+    namespace native
+    {
+        // the shards of the metrics are kept on separate cache lines on SMP
+        #ifdef TX_THREAD_SMP_MAX_CORES
+        constexpr std::size_t SHARD_ALIGNMENT = 64;
+        #else
+        constexpr std::size_t SHARD_ALIGNMENT = alignof(std::atomic<std::uint32_t>);
+        #endif
+    }
+
+    /// @brief  The base class of the named metrics, which register themselves
+    ///         into a global list upon construction, typically as static objects.
+    ///         The updates are relaxed atomic operations on the current core's shard,
+    ///         the readers merge the shards.
+    class metric
+    {
+    public:
+        /// @brief  The type of the metric, for downcasting.
+        enum class kind
+        {
+            counter,
+            gauge,
+            histogram,
+        };
+
+        /// @brief  Function to observe the name of the metric.
+        const char* get_name() const
+        {
+            return name_;
+        }
+
+        /// @brief  Function to observe the type of the metric.
+        kind get_kind() const
+        {
+            return kind_;
+        }
+
+        /// @brief  Function to observe the next registered metric.
+        /// @return The next metric, nullptr at the end of the list
+        const metric* get_next() const
+        {
+            return next_;
+        }
+
+        /// @brief  Function to observe the first registered metric.
+        /// @return The first metric, nullptr if there are none
+        static const metric* get_first();
+
+        // non-copyable
+        metric(const metric&) = delete;
+        metric& operator=(const metric&) = delete;
+
+    protected:
+        metric(const char *name, kind k);
+        ~metric();
+
+    private:
+        const char *const name_;
+        const kind kind_;
+        metric *next_;
+    };
+
+    /// @brief  A monotonic event counter, which wraps around on overflow.
+    class counter : public metric
+    {
+    public:
+        using value_type = std::uint32_t;
+
+        /// @brief  Counts events.
+        /// @param  n: the number of events
+        /// @remark Thread and ISR context callable
+        inline void add(value_type n = 1)
+        {
+            shards_[this_cpu::get_core_id()].value.fetch_add(n, std::memory_order_relaxed);
+        }
+
+        /// @brief  Merges the shards of the counter.
+        /// @return The number of counted events
+        value_type get_value() const;
+
+        /// @brief  Registers a named counter.
+        explicit counter(const char *name)
+            : metric(name, kind::counter), shards_()
+        {
+        }
+
+    private:
+        struct alignas(native::SHARD_ALIGNMENT) shard
+        {
+            std::atomic<value_type> value;
+        };
+        shard shards_[native::CORE_COUNT];
+    };
+
+    /// @brief  An instantaneous value, e.g. a queue depth, with its high watermark.
+    class gauge : public metric
+    {
+    public:
+        using value_type = std::int32_t;
+
+        /// @brief  Sets the value of the gauge.
+        /// @remark Thread and ISR context callable
+        inline void set(value_type value)
+        {
+            value_.store(value, std::memory_order_relaxed);
+            update_max(value);
+        }
+
+        /// @brief  Changes the value of the gauge.
+        /// @remark Thread and ISR context callable
+        inline void add(value_type delta)
+        {
+            update_max(value_.fetch_add(delta, std::memory_order_relaxed) + delta);
+        }
+
+        /// @brief  Function to observe the value of the gauge.
+        value_type get_value() const
+        {
+            return value_.load(std::memory_order_relaxed);
+        }
+
+        /// @brief  Function to observe the highest value of the gauge.
+        value_type get_max() const
+        {
+            return max_.load(std::memory_order_relaxed);
+        }
+
+        /// @brief  Restarts the high watermark from the current value.
+        void reset_max()
+        {
+            max_.store(get_value(), std::memory_order_relaxed);
+        }
+
+        /// @brief  Registers a named gauge.
+        explicit gauge(const char *name, value_type initial = 0)
+            : metric(name, kind::gauge), value_(initial), max_(initial)
+        {
+        }
+
+    private:
+        inline void update_max(value_type value)
+        {
+            value_type max = max_.load(std::memory_order_relaxed);
+            while ((value > max) && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        std::atomic<value_type> value_;
+        std::atomic<value_type> max_;
+    };
+
+    /// @brief  A histogram of unsigned values, e.g. latencies, with log-linear buckets:
+    ///         each power of two range is split into 2^SUB_BUCKET_BITS linear buckets,
+    ///         so the relative error of the recorded values is bounded.
+    class histogram : public metric
+    {
+    public:
+        using value_type = std::uint32_t;
+        using count_type = std::uint32_t;
+
+        static constexpr unsigned SUB_BUCKET_BITS = 2;
+        static constexpr unsigned SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+        static constexpr unsigned BUCKET_COUNT = (32 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+        /// @brief  A merged copy of the histogram's buckets.
+        struct snapshot
+        {
+            count_type buckets[BUCKET_COUNT];
+
+            /// @brief  Adds the counts of another snapshot.
+            void merge(const snapshot& other);
+
+            /// @brief  Returns the total number of recorded values.
+            count_type get_count() const;
+
+            /// @brief  Estimates a quantile of the recorded values.
+            /// @param  q: the quantile in the range [0, 1]
+            /// @return The upper bound of the bucket holding the quantile
+            value_type get_quantile(float q) const;
+        };
+
+        /// @brief  Records a value.
+        /// @remark Thread and ISR context callable
+        inline void record(value_type value)
+        {
+            shards_[this_cpu::get_core_id()].buckets[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /// @brief  Merges the shards of the histogram.
+        /// @param  s: the destination snapshot
+        void get_snapshot(snapshot& s) const;
+
+        /// @brief  Determines the bucket of a value.
+        static unsigned bucket_of(value_type value)
+        {
+            if (value < SUB_BUCKETS)
+            {
+                return value;
+            }
+            const unsigned msb = 31 - __builtin_clz(value);
+            return ((msb - SUB_BUCKET_BITS + 1) << SUB_BUCKET_BITS) +
+                    ((value >> (msb - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1));
+        }
+
+        /// @brief  Determines the largest value in a bucket.
+        static value_type bucket_upper_bound(unsigned bucket);
+
+        /// @brief  Registers a named histogram.
+        explicit histogram(const char *name)
+            : metric(name, kind::histogram), shards_()
+        {
+        }
+
+    private:
+        struct alignas(native::SHARD_ALIGNMENT) shard
+        {
+            std::atomic<count_type> buckets[BUCKET_COUNT];
+        };
+        shard shards_[native::CORE_COUNT];
+    };
+}
+
+#endif // __THREADX_METRICS_H_
@@ -75,9 +75,17 @@ namespace threadx
         /// @return The mutex's current holder thread, or nullptr if the mutex is unlocked
         thread *get_locking_thread() const;
 
+        /// @brief  Releases all (recursive) locks of the calling thread at once.
+        ///         The mutex becomes unlocked, or passes to the next waiting thread.
+        /// @note   May only be called when the mutex isn't locked by another thread
+        void unlock_all();
+
         /// @brief  Constructs a mutex statically.
         mutex();
 
+        /// @brief  Deletes the mutex, the waiting threads return unsuccessfully.
+        ~mutex();
+
         // non-copyable
         mutex(const mutex&) = delete;
         mutex& operator=(const mutex&) = delete;
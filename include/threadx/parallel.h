@@ -0,0 +1,267 @@
+/**
+ * @file      parallel.h
+ * @brief     ThreadX parallel algorithms over a worker team
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __THREADX_PARALLEL_H_
+#define __THREADX_PARALLEL_H_
+
+#include <atomic>
+#include <new>
+#include <type_traits>
+#include "threadx/cpu.h"
+#include "threadx/mutex.h"
+#include "threadx/semaphore.h"
+#include "threadx/thread.h"
+
+namespace threadx
+{
+    /// @brief  Work distribution strategies of the parallel algorithms.
+    enum class partition
+    {
+        fixed,      ///< the range is split evenly between the participants upfront
+        dynamic,    ///< the participants take grain sized chunks until the range is exhausted
+    };
+
+    /// @brief  A persistent team of worker threads, which execute a range of work
+    ///         together with the calling thread, see @ref parallel_for.
+    class worker_team
+    {
+    public:
+        using chunk_function = void (*)(void *context, std::size_t first, std::size_t last, std::size_t participant);
+
+        /// @brief  The number of threads executing a job, including the caller.
+        /// @return The number of participants
+        std::size_t size() const
+        {
+            return workers_count_ + 1;
+        }
+
+        /// @brief  Executes a function over a range with all participants,
+        ///         and waits until the whole range is processed.
+        /// @param  first:   the start of the range
+        /// @param  last:    the end of the range (excluded)
+        /// @param  grain:   the minimum chunk size
+        /// @param  p:       the work distribution strategy
+        /// @param  func:    the function to call with each chunk
+        /// @param  context: opaque parameter to pass to the function
+        void run(std::size_t first, std::size_t last, std::size_t grain, partition p,
+                chunk_function func, void *context);
+
+        // non-copyable
+        worker_team(const worker_team&) = delete;
+        worker_team& operator=(const worker_team&) = delete;
+
+    protected:
+        struct worker
+        {
+            worker_team *team;
+            std::size_t index;
+            binary_semaphore start;
+        };
+
+        static void worker_main(worker *w);
+
+        worker_team(worker *workers, std::size_t count);
+
+    private:
+        void execute(std::size_t participant);
+
+        worker *const workers_;
+        const std::size_t workers_count_;
+        mutex mutex_;
+        counting_semaphore<> done_;
+
+        std::atomic<std::size_t> next_;
+        std::size_t first_;
+        std::size_t last_;
+        std::size_t grain_;
+        partition partition_;
+        chunk_function func_;
+        void *context_;
+    };
+
+    /// @brief  A worker team with statically allocated worker threads.
+    ///         By default the team has a worker for each additional SMP core,
+    ///         so on single-core builds it has no threads at all.
+    template<const std::size_t STACK_SIZE_BYTES, const std::size_t WORKER_COUNT = native::CORE_COUNT - 1>
+    class static_worker_team : public worker_team
+    {
+    public:
+        static constexpr std::size_t WORKERS = WORKER_COUNT;
+        static constexpr std::size_t STACK_SIZE = STACK_SIZE_BYTES * WORKERS;
+
+        /// @brief  Constructs the team, starting its worker threads.
+        /// @param  prio: the workers' priority level
+        /// @param  name: short label for identifying the workers
+        static_worker_team(thread::priority prio = thread::priority(), const char *name = "worker")
+            : worker_team(workers_, WORKERS)
+        {
+            for (std::size_t i = 0; i < WORKERS; i++)
+            {
+                workers_[i].team = this;
+                workers_[i].index = i;
+                new (&threads_[i]) static_thread<STACK_SIZE_BYTES>(&worker_team::worker_main, &workers_[i], prio, name);
+            }
+        }
+
+        /// @brief  Stops and deletes the worker threads.
+        ~static_worker_team()
+        {
+            for (std::size_t i = 0; i < WORKERS; i++)
+            {
+                reinterpret_cast<static_thread<STACK_SIZE_BYTES>*>(&threads_[i])->~static_thread();
+            }
+        }
+
+    private:
+        worker workers_[WORKERS];
+        typename std::aligned_storage<sizeof(static_thread<STACK_SIZE_BYTES>),
+                alignof(static_thread<STACK_SIZE_BYTES>)>::type threads_[WORKERS];
+    };
+
+    /// @brief  Without workers the parallel algorithms run as plain loops in the calling thread.
+    template<const std::size_t STACK_SIZE_BYTES>
+    class static_worker_team<STACK_SIZE_BYTES, 0>
+    {
+    public:
+        static constexpr std::size_t WORKERS = 0;
+        static constexpr std::size_t STACK_SIZE = 0;
+
+        static constexpr std::size_t size()
+        {
+            return 1;
+        }
+
+        static_worker_team(thread::priority prio = thread::priority(), const char *name = "worker")
+        {
+            (void)prio;
+            (void)name;
+        }
+    };
+
+    namespace detail
+    {
+        template<class Function>
+        void parallel_for_chunk(void *context, std::size_t first, std::size_t last, std::size_t participant)
+        {
+            (void)participant;
+            Function& fn = *static_cast<Function*>(context);
+            for (std::size_t i = first; i < last; i++)
+            {
+                fn(i);
+            }
+        }
+
+        template<class Team>
+        inline void run_chunks(Team& team, std::size_t first, std::size_t last, std::size_t grain,
+                partition p, worker_team::chunk_function func, void *context, std::true_type)
+        {
+            team.run(first, last, grain, p, func, context);
+        }
+
+        template<class Team>
+        inline void run_chunks(Team&, std::size_t first, std::size_t last, std::size_t,
+                partition, worker_team::chunk_function func, void *context, std::false_type)
+        {
+            func(context, first, last, 0);
+        }
+
+        template<class Team>
+        inline void run_chunks(Team& team, std::size_t first, std::size_t last, std::size_t grain,
+                partition p, worker_team::chunk_function func, void *context)
+        {
+            run_chunks(team, first, last, grain, p, func, context,
+                    std::integral_constant<bool, (Team::WORKERS > 0)>());
+        }
+
+        template<typename T, class Map, class Reduce>
+        struct parallel_reduce_context
+        {
+            T *partials;
+            Map& map;
+            Reduce& reduce;
+
+            static void chunk(void *context, std::size_t first, std::size_t last, std::size_t participant)
+            {
+                auto& ctx = *static_cast<parallel_reduce_context*>(context);
+                T& acc = ctx.partials[participant];
+                for (std::size_t i = first; i < last; i++)
+                {
+                    acc = ctx.reduce(acc, ctx.map(i));
+                }
+            }
+        };
+    }
+
+    /// @brief  Calls a function for each index of a range, distributing the work
+    ///         between the team's workers and the calling thread.
+    /// @param  team:  the worker team to execute with
+    /// @param  first: the start of the range
+    /// @param  last:  the end of the range (excluded)
+    /// @param  grain: the minimum number of indexes to process in one chunk
+    /// @param  fn:    the function to call with each index, as fn(i)
+    /// @param  p:     the work distribution strategy
+    template<class Team, class Function>
+    void parallel_for(Team& team, std::size_t first, std::size_t last, std::size_t grain,
+            Function fn, partition p = partition::dynamic)
+    {
+        detail::run_chunks(team, first, last, grain, p,
+                &detail::parallel_for_chunk<Function>, static_cast<void*>(&fn));
+    }
+
+    /// @brief  Reduces the values mapped from each index of a range, distributing the work
+    ///         between the team's workers and the calling thread.
+    /// @param  team:     the worker team to execute with
+    /// @param  first:    the start of the range
+    /// @param  last:     the end of the range (excluded)
+    /// @param  grain:    the minimum number of indexes to process in one chunk
+    /// @param  identity: the identity element of the reduction
+    /// @param  map:      the function producing the value of an index, as map(i)
+    /// @param  reduce:   the associative function combining two values, as reduce(a, b)
+    /// @param  p:        the work distribution strategy
+    /// @return The reduction of all mapped values
+    template<class Team, typename T, class Map, class Reduce>
+    T parallel_reduce(Team& team, std::size_t first, std::size_t last, std::size_t grain,
+            T identity, Map map, Reduce reduce, partition p = partition::dynamic)
+    {
+        T partials[Team::WORKERS + 1];
+        for (auto& partial : partials)
+        {
+            partial = identity;
+        }
+
+        detail::parallel_reduce_context<T, Map, Reduce> ctx { partials, map, reduce };
+        detail::run_chunks(team, first, last, grain, p,
+                &decltype(ctx)::chunk, static_cast<void*>(&ctx));
+
+        T result = partials[0];
+        for (std::size_t i = 1; i < (Team::WORKERS + 1); i++)
+        {
+            result = reduce(result, partials[i]);
+        }
+        return result;
+    }
+}
+
+#endif // __THREADX_PARALLEL_H_
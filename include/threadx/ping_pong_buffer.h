@@ -0,0 +1,111 @@
+/**
+ * @file      ping_pong_buffer.h
+ * @brief     ThreadX double buffer with blocking handoff
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __THREADX_PING_PONG_BUFFER_H_
+#define __THREADX_PING_PONG_BUFFER_H_
+
+#include "threadx/semaphore.h"
+
+namespace threadx
+{
+    /// @brief  A double buffer with blocking handoff between a single producer and a single consumer.
+    ///         The producer fills one buffer while the consumer processes the other,
+    ///         so no value is lost, and each side only blocks when it got ahead of the other.
+    template<typename T>
+    class ping_pong_buffer
+    {
+    public:
+        using value_type = T;
+
+        /// @brief  Waits until a buffer is free for the producer.
+        /// @return Reference to the buffer to fill
+        T& begin_write()
+        {
+            free_.acquire();
+            return buffers_[write_];
+        }
+
+        /// @brief  Tries to get a free buffer for the producer within the given time duration.
+        /// @param  rel_time: duration to wait for the consumer to release a buffer
+        /// @return Pointer to the buffer to fill, or nullptr if timed out
+        template<class Rep, class Period>
+        T* try_begin_write_for(const std::chrono::duration<Rep, Period>& rel_time)
+        {
+            return free_.try_acquire_for(rel_time) ? &buffers_[write_] : nullptr;
+        }
+
+        /// @brief  Hands the filled buffer over to the consumer.
+        /// @remark Thread and ISR context callable
+        void end_write()
+        {
+            write_ ^= 1;
+            filled_.release();
+        }
+
+        /// @brief  Waits until a filled buffer is handed over to the consumer.
+        /// @return Reference to the buffer to process
+        T& begin_read()
+        {
+            filled_.acquire();
+            return buffers_[read_];
+        }
+
+        /// @brief  Tries to get a filled buffer for the consumer within the given time duration.
+        /// @param  rel_time: duration to wait for the producer to hand over a buffer
+        /// @return Pointer to the buffer to process, or nullptr if timed out
+        template<class Rep, class Period>
+        T* try_begin_read_for(const std::chrono::duration<Rep, Period>& rel_time)
+        {
+            return filled_.try_acquire_for(rel_time) ? &buffers_[read_] : nullptr;
+        }
+
+        /// @brief  Gives the processed buffer back to the producer.
+        /// @remark Thread and ISR context callable
+        void end_read()
+        {
+            read_ ^= 1;
+            free_.release();
+        }
+
+        /// @brief  Constructs the buffers, both free for the producer.
+        ping_pong_buffer()
+            : free_(2), filled_(0)
+        {
+        }
+
+        // non-copyable
+        ping_pong_buffer(const ping_pong_buffer&) = delete;
+        ping_pong_buffer& operator=(const ping_pong_buffer&) = delete;
+
+    private:
+        T buffers_[2];
+        unsigned char write_ = 0;
+        unsigned char read_ = 0;
+        counting_semaphore<2> free_;
+        counting_semaphore<2> filled_;
+    };
+}
+
+#endif // __THREADX_PING_PONG_BUFFER_H_
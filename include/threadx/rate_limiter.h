@@ -0,0 +1,121 @@
+/**
+ * @file      rate_limiter.h
+ * @brief     ThreadX token bucket rate limiter
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __THREADX_RATE_LIMITER_H_
+#define __THREADX_RATE_LIMITER_H_
+
+#include <atomic>
+#include "threadx/tick_timer.h"
+
+namespace threadx
+{
+    /// @brief  A token bucket rate limiter, which refills its tokens lazily
+    ///         based on the elapsed @ref tick_timer time, without any timer or thread.
+    class rate_limiter
+    {
+    public:
+        using count_type = native::ULONG;
+
+        /// @brief  Takes a token from the bucket, blocks until one is available.
+        inline void acquire()
+        {
+            (void)get(1, infinity);
+        }
+
+        /// @brief  Takes a given number of tokens from the bucket,
+        ///         blocks until enough tokens are available.
+        /// @param  n: the number of tokens to take (mustn't exceed @ref max)
+        inline void acquire(count_type n)
+        {
+            (void)get(n, infinity);
+        }
+
+        /// @brief  Tries to take a given number of tokens from the bucket without blocking.
+        /// @param  n: the number of tokens to take
+        /// @return true if successful, false if not enough tokens are available
+        /// @remark Thread and ISR context callable
+        bool try_acquire(count_type n = 1);
+
+        /// @brief  Tries to take a given number of tokens from the bucket within the given time duration.
+        ///         The calling thread sleeps until the bucket is refilled sufficiently.
+        /// @param  n:        the number of tokens to take (mustn't exceed @ref max)
+        /// @param  rel_time: duration to wait for the tokens to become available
+        /// @return true if successful, false if not enough tokens become available in time
+        template<class Rep, class Period>
+        inline bool try_acquire_for(count_type n, const std::chrono::duration<Rep, Period>& rel_time)
+        {
+            return get(n, std::chrono::duration_cast<tick_timer::duration>(rel_time));
+        }
+
+        /// @brief  Tries to take a given number of tokens from the bucket until the given deadline.
+        /// @param  n:        the number of tokens to take (mustn't exceed @ref max)
+        /// @param  abs_time: deadline to wait until the tokens become available
+        /// @return true if successful, false if not enough tokens become available in time
+        template<class Clock, class Duration>
+        inline bool try_acquire_until(count_type n, const std::chrono::time_point<Clock, Duration>& abs_time)
+        {
+            return try_acquire_for(n, abs_time - Clock::now());
+        }
+
+        /// @brief  Function to observe the bucket's current token count.
+        /// @return The number of tokens that can be taken immediately
+        count_type get_count();
+
+        /// @brief  The capacity of the bucket.
+        /// @return The maximum number of tokens that can accumulate
+        count_type max() const
+        {
+            return capacity_;
+        }
+
+        /// @brief  Constructs a rate limiter with a full bucket.
+        /// @param  capacity: the maximum number of tokens in the bucket (the burst size)
+        /// @param  tokens:   the number of tokens to add to the bucket each period
+        /// @param  period:   the refill period
+        template<class Rep, class Period>
+        rate_limiter(count_type capacity, count_type tokens, const std::chrono::duration<Rep, Period>& period)
+            : rate_limiter(capacity, tokens, std::chrono::duration_cast<tick_timer::duration>(period))
+        {
+        }
+
+        rate_limiter(count_type capacity, count_type tokens, tick_timer::duration period);
+
+        // non-copyable
+        rate_limiter(const rate_limiter&) = delete;
+        rate_limiter& operator=(const rate_limiter&) = delete;
+
+    private:
+        void refill(tick_timer::rep now);
+        bool get(count_type n, tick_timer::duration timeout);
+
+        const count_type capacity_;
+        const count_type tokens_;
+        const tick_timer::rep period_;
+        std::atomic<count_type> count_;
+        std::atomic<tick_timer::rep> last_refill_;
+    };
+}
+
+#endif // __THREADX_RATE_LIMITER_H_
@@ -0,0 +1,144 @@
+/**
+ * @file      rpc_server.h
+ * @brief     Synchronous RPC server with priority donation
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __THREADX_RPC_SERVER_H_
+#define __THREADX_RPC_SERVER_H_
+
+#include "threadx/mutex.h"
+#include "threadx/semaphore.h"
+#include "threadx/thread.h"
+
+namespace threadx
+{
+    namespace detail
+    {
+        /// @brief  The call context of a client, reused for each of its calls.
+        struct rpc_slot
+        {
+            const void *request;
+            void *response;
+            thread::priority priority;
+            rpc_slot *next;
+            binary_semaphore done;
+
+            rpc_slot()
+                : request(nullptr), response(nullptr), priority(), next(nullptr), done()
+            {
+            }
+        };
+
+        /// @brief  The non-template part of @ref rpc_server.
+        class rpc_queue
+        {
+        protected:
+            void call(rpc_slot& slot, const void *request, void *response);
+            rpc_slot& get();
+            void put(rpc_slot& slot);
+
+            rpc_queue();
+
+        private:
+            mutex mutex_;
+            counting_semaphore<> requests_;
+            rpc_slot *pending_;
+            thread *server_;
+            thread::priority base_priority_;
+        };
+    }
+
+    /// @brief  A synchronous remote procedure call server, which handles the requests
+    ///         of its clients in priority order. The server thread runs at the priority
+    ///         of its most urgent client, so the latency of a call follows the client's priority.
+    ///         Less urgent clients are served at the server thread's own priority.
+    template<typename Req, typename Resp>
+    class rpc_server : private detail::rpc_queue
+    {
+    public:
+        using request_type = Req;
+        using response_type = Resp;
+
+        /// @brief  A client of the server, which is used by a single thread at a time.
+        class client : private detail::rpc_slot
+        {
+        public:
+            /// @brief  Passes the request to the server, and waits for the response.
+            ///         The server thread's priority is raised to the caller's for the duration.
+            /// @param  request:  the request to handle
+            /// @param  response: the destination of the response
+            /// @remark Thread context callable
+            inline void call(const Req& request, Resp& response)
+            {
+                server_.call(*this, &request, &response);
+            }
+
+            /// @brief  Creates a client with its reusable call context.
+            /// @param  server: the server to call
+            explicit client(rpc_server& server)
+                : rpc_slot(), server_(server)
+            {
+            }
+
+            // non-copyable
+            client(const client&) = delete;
+            client& operator=(const client&) = delete;
+
+        private:
+            rpc_server& server_;
+        };
+
+        /// @brief  Waits for the most urgent request, and handles it.
+        /// @param  handler: the function that fills the response: void(const Req&, Resp&)
+        /// @remark Server thread context callable
+        template<class Handler>
+        void serve_one(Handler handler)
+        {
+            detail::rpc_slot& slot = get();
+            handler(*static_cast<const Req*>(slot.request), *static_cast<Resp*>(slot.response));
+            put(slot);
+        }
+
+        /// @brief  Handles the requests continuously, the entry function of the server thread.
+        /// @param  handler: the function that fills the response: void(const Req&, Resp&)
+        template<class Handler>
+        [[noreturn]] void serve(Handler handler)
+        {
+            while (true)
+            {
+                serve_one(handler);
+            }
+        }
+
+        rpc_server()
+            : rpc_queue()
+        {
+        }
+
+        // non-copyable
+        rpc_server(const rpc_server&) = delete;
+        rpc_server& operator=(const rpc_server&) = delete;
+    };
+}
+
+#endif // __THREADX_RPC_SERVER_H_
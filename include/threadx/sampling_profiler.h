@@ -0,0 +1,74 @@
+/**
+ * @file      sampling_profiler.h
+ * @brief     Tick driven sampling profiler
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __THREADX_SAMPLING_PROFILER_H_
+#define __THREADX_SAMPLING_PROFILER_H_
+
+#include <cstdint>
+#include "threadx/cpu.h"
+
+namespace threadx
+{
+    /// @brief  A statistical profiler, which samples the running thread (and optionally
+    ///         its program counter) on each tick. The samples are shipped by @ref drain,
+    ///         and folded into flame graphs by the host (tools/profile_fold.py).
+    class sampling_profiler
+    {
+    public:
+        /// @brief  A single observation of the CPU.
+        struct sample
+        {
+            std::uint32_t thread;   ///< the id of the running thread, 0 if the CPU was idle
+            std::uint32_t pc;       ///< the interrupted program counter, 0 if not provided
+        };
+
+        /// @brief  Function that ships a batch of samples, e.g. to a UART or a file.
+        using sink = void (*)(const sample *samples, std::size_t count);
+
+        /// @brief  Takes a sample of the current core, to be called from the application's
+        ///         tick interrupt handler.
+        /// @param  pc: the program counter of the interrupted context, which the port specific
+        ///             handler can take from the exception stack frame, or nullptr
+        /// @remark ISR context callable
+        static void on_tick(const void *pc = nullptr);
+
+        /// @brief  Starts collecting the samples.
+        static void start();
+
+        /// @brief  Stops collecting the samples.
+        static void stop();
+
+        /// @brief  Ships the collected samples to the sink.
+        /// @param  s: the destination of the samples
+        /// @return The number of shipped samples
+        /// @note   Only a single thread should drain the samples.
+        static std::size_t drain(sink s);
+
+        /// @brief  Function to observe the number of samples lost due to a full buffer.
+        static std::size_t get_dropped();
+    };
+}
+
+#endif // __THREADX_SAMPLING_PROFILER_H_
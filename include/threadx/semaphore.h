@@ -78,6 +78,14 @@ namespace threadx
         /// @return The semaphore's acquirable count
         count_type get_count() const;
 
+        /// @brief  Reinitializes the semaphore's count in place, without recreating the kernel object.
+        ///         If threads are waiting for the semaphore, they receive the new count.
+        /// @param  desired: the new acquirable count
+        void reset(count_type desired = 0);
+
+        /// @brief  Deletes the semaphore, the waiting threads return unsuccessfully.
+        ~semaphore();
+
         // non-copyable
         semaphore(const semaphore&) = delete;
         semaphore& operator=(const semaphore&) = delete;
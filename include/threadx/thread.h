@@ -84,6 +84,10 @@ namespace threadx
         /// @return The current state of the thread
         state get_state() const;
 
+        /// @brief  Reads the thread's unused stack space, as of its last context switch.
+        /// @return The number of bytes between the stack start and the saved stack pointer
+        std::size_t get_stack_space() const;
+
         /// @brief  Returns the currently executing thread.
         /// @return Pointer to the currently executing thread
         static thread* get_current();
@@ -140,13 +144,21 @@ namespace threadx
             void set_entry_exit_callback(entry_exit_callback func, void* param);
             entry_exit_callback get_entry_exit_callback() const;
             void* get_entry_exit_param() const;
-            static void join_exit_callback(thread *t, native::UINT id);
+            static void exit_callback(thread *t, native::UINT id);
 
         public:
             /// @brief  Waits for the thread to finish execution.
-            /// @note   May only be called when the thread is joinable, and not from the owned thread's context
+            /// @note   May only be called when the thread isn't joined or detached yet,
+            ///         and not from the owned thread's context
             void join();
 
+            /// @brief  Separates the thread's execution from the thread object.
+            ///         If the thread was created by a @ref thread_pool, its resources are
+            ///         returned to the pool automatically when the thread exits.
+            /// @note   May only be called when the thread isn't joined or detached yet
+            /// @remark Thread and ISR context callable
+            void detach();
+
             /// @brief  Checks if the thread is joinable (potentially executing).
             /// @return true if the thread is valid and hasn't been joined, false otherwise
             /// @remark Thread and ISR context callable
@@ -163,6 +175,8 @@ namespace threadx
                 priority prio, const char *name);
 
     private:
+        friend class thread_pool;
+
         // non-copyable
         thread(const thread&) = delete;
         thread& operator=(const thread&) = delete;
@@ -171,6 +185,19 @@ namespace threadx
         thread& operator=(const thread&&) = delete;
     };
 
+    namespace detail
+    {
+        /// @brief  Converts a member function to a thread function, which receives the object
+        ///         as its parameter, using GCC's extraction of the function from a pointer to member.
+        template<class T>
+        inline thread::function member_entry(void (T::*member_func)())
+        {
+            #pragma GCC diagnostic push
+            #pragma GCC diagnostic ignored "-Wpmf-conversions"
+            return reinterpret_cast<thread::function>(member_func);
+            #pragma GCC diagnostic pop
+        }
+    }
 
     /// @brief  A thread with statically allocated stack.
     template <const std::size_t STACK_SIZE_BYTES>
@@ -181,7 +208,7 @@ namespace threadx
 
         /// @brief  Constructs a static thread. The thread becomes ready to execute
         ///         within this call, meaning that it might have started running
-        ///         by the time this call returns.
+        ///         by the time this call returns, unless a @ref thread_group defers its start.
         /// @param  func:      the function to execute in the thread context
         /// @param  param:     opaque parameter to pass to the thread function
         /// @param  prio:      thread priority level
@@ -189,7 +216,7 @@ namespace threadx
         static_thread(function func, void *param,
                 priority prio = priority(), const char *name = DEFAULT_NAME)
             : thread(stack_, sizeof(stack_) / sizeof(stack_[0]),
-                    func, param, prio, name)
+                    func, reinterpret_cast<native::ULONG>(param), prio, name)
         {
         }
 
@@ -216,7 +243,7 @@ namespace threadx
         static_thread(void (*func)(T*), T& arg,
                 priority prio = priority(), const char *name = DEFAULT_NAME)
             : static_thread(reinterpret_cast<function>(func),
-                    reinterpret_cast<void*>(arg),
+                    reinterpret_cast<void*>(&arg),
                     prio, name)
         {
         }
@@ -224,7 +251,7 @@ namespace threadx
         template<class T>
         static_thread(T& obj, void (T::*member_func)(),
                 priority prio = priority(), const char *name = DEFAULT_NAME)
-            : static_thread(reinterpret_cast<function>(member_func),
+            : static_thread(detail::member_entry(member_func),
                     reinterpret_cast<void*>(&obj),
                     prio, name)
         {
@@ -242,6 +269,80 @@ namespace threadx
     };
 
 
+    /// @brief  A movable reference to a @ref thread, which can be stored in containers
+    ///         and transferred between owners. An owning handle joins the thread
+    ///         when it's destroyed or reassigned.
+    class thread_handle
+    {
+    public:
+        /// @brief  Constructs an empty handle.
+        constexpr thread_handle()
+            : thread_(nullptr), owning_(false)
+        {
+        }
+
+        /// @brief  Constructs a handle referencing a thread.
+        /// @param  t:      the referenced thread
+        /// @param  owning: whether the handle owns the thread's execution
+        explicit thread_handle(thread& t, bool owning = false)
+            : thread_(&t), owning_(owning)
+        {
+        }
+
+        thread_handle(thread_handle&& other);
+        thread_handle& operator=(thread_handle&& other);
+
+        /// @brief  Joins the thread if the handle owns it.
+        ~thread_handle();
+
+        /// @brief  Provides the referenced thread.
+        /// @return Pointer to the thread, or nullptr if the handle is empty
+        thread* get() const
+        {
+            return thread_;
+        }
+        thread* operator->() const
+        {
+            return thread_;
+        }
+        explicit operator bool() const
+        {
+            return thread_ != nullptr;
+        }
+
+        /// @brief  Provides the referenced thread's unique identifier.
+        /// @return The thread's unique identifier, or 0 if the handle is empty
+        thread::id get_id() const;
+
+        /// @brief  Releases the referenced thread, which continues its execution unobserved.
+        ///         An owning handle detaches the thread (see @ref thread::detach).
+        ///         The handle becomes empty.
+        void detach();
+
+        #ifndef TX_DISABLE_NOTIFY_CALLBACKS
+
+            /// @brief  Checks if the referenced thread is joinable.
+            /// @return true if the handle isn't empty and the thread is joinable, false otherwise
+            bool joinable() const;
+
+            /// @brief  Waits for the referenced thread to finish execution. The handle becomes empty.
+            /// @note   May only be called when the handle isn't empty
+            void join();
+
+        #endif // !TX_DISABLE_NOTIFY_CALLBACKS
+
+        // non-copyable
+        thread_handle(const thread_handle&) = delete;
+        thread_handle& operator=(const thread_handle&) = delete;
+
+    private:
+        void release();
+
+        thread *thread_;
+        bool owning_;
+    };
+
+
     /// @brief  Namespace offering control on the current thread of execution.
     namespace this_thread
     {
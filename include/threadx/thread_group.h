@@ -0,0 +1,92 @@
+/**
+ * @file      thread_group.h
+ * @brief     Deferred start of a group of threads
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __THREADX_THREAD_GROUP_H_
+#define __THREADX_THREAD_GROUP_H_
+
+#include "threadx/thread.h"
+
+namespace threadx
+{
+    /// @brief  A scope guard that defers the start of the threads created in its scope,
+    ///         by the same context, until @ref start_all is called, or the scope ends.
+    ///         The threads of the group are started at once, without preempting the caller
+    ///         or each other midway, so the startup order has no effect on the application.
+    ///         A thread destroyed before the start leaves the group.
+    class thread_group
+    {
+    public:
+        /// @brief  Starts all threads of the group, and stops collecting further threads.
+        void start_all();
+
+        /// @brief  Function to observe the number of threads waiting to be started.
+        std::size_t size() const
+        {
+            return count_;
+        }
+
+        /// @brief  Starts the threads that haven't been started yet.
+        ~thread_group();
+
+        // non-copyable
+        thread_group(const thread_group&) = delete;
+        thread_group& operator=(const thread_group&) = delete;
+
+    protected:
+        thread_group(thread **storage, std::size_t capacity);
+
+    private:
+        friend class thread;
+
+        static bool defer(thread& t);
+        static void forget(thread& t);
+        void deactivate();
+
+        thread **const storage_;
+        const std::size_t capacity_;
+        std::size_t count_;
+        thread *const owner_;
+        thread_group *previous_;
+        bool active_;
+    };
+
+    /// @brief  A thread group with statically allocated storage.
+    /// @tparam MAX_THREADS: the maximal number of threads whose start is deferred
+    template<const std::size_t MAX_THREADS>
+    class static_thread_group : public thread_group
+    {
+    public:
+        /// @brief  Starts collecting the threads created by the calling context.
+        static_thread_group()
+            : thread_group(threads_, MAX_THREADS)
+        {
+        }
+
+    private:
+        thread *threads_[MAX_THREADS];
+    };
+}
+
+#endif // __THREADX_THREAD_GROUP_H_
@@ -0,0 +1,130 @@
+/**
+ * @file      thread_pool.h
+ * @brief     ThreadX pool of runtime created threads
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __THREADX_THREAD_POOL_H_
+#define __THREADX_THREAD_POOL_H_
+
+#include <type_traits>
+#include "threadx/thread.h"
+
+namespace threadx
+{
+    /// @brief  A pool of thread slots (control block and stack), from which threads
+    ///         can be created at runtime. The slot of a finished thread is returned
+    ///         to the pool by the thread's exit callback once it's joined or detached,
+    ///         so fire-and-forget threads need no reaper.
+    /// @note   Without the notify callbacks (TX_DISABLE_NOTIFY_CALLBACKS) the slots are never reclaimed
+    class thread_pool
+    {
+    public:
+        /// @brief  Creates a thread in a free slot of the pool. The thread becomes ready
+        ///         to execute within this call.
+        /// @param  func:  the function to execute in the thread context
+        /// @param  param: opaque parameter to pass to the thread function
+        /// @param  prio:  thread priority level
+        /// @param  name:  short label for identifying the thread
+        /// @return An owning handle of the created thread, or an empty handle if the pool is exhausted
+        thread_handle create(thread::function func, void *param,
+                thread::priority prio = thread::priority(), const char *name = DEFAULT_NAME);
+
+        template<typename T>
+        thread_handle create(void (*func)(T*), T* arg,
+                thread::priority prio = thread::priority(), const char *name = DEFAULT_NAME)
+        {
+            return create(reinterpret_cast<thread::function>(func),
+                    reinterpret_cast<void*>(arg), prio, name);
+        }
+
+        template<class T>
+        thread_handle create(T& obj, void (T::*member_func)(),
+                thread::priority prio = thread::priority(), const char *name = DEFAULT_NAME)
+        {
+            return create(detail::member_entry(member_func),
+                    reinterpret_cast<void*>(&obj), prio, name);
+        }
+
+        /// @brief  Function to observe the pool's free slots.
+        /// @return The number of threads that can be created
+        std::size_t available() const;
+
+        /// @brief  Returns the slot of a finished thread to its pool.
+        /// @param  t: the finished thread, which is ignored if it isn't from a pool
+        static void reclaim(thread *t);
+
+        /// @brief  Stops and deletes the threads of the pool.
+        ~thread_pool();
+
+        // non-copyable
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+    protected:
+        static constexpr const char* DEFAULT_NAME = "pooled";
+
+        struct slot
+        {
+            typename std::aligned_storage<sizeof(thread), alignof(thread)>::type storage;
+            slot *next;
+            bool constructed;
+            bool in_use;
+        };
+
+        thread_pool(slot *slots, unsigned char *stacks, std::size_t count, std::size_t stack_size);
+
+    private:
+        class pooled_thread;
+
+        slot *find(thread *t) const;
+        void release(slot *s);
+
+        slot *const slots_;
+        unsigned char *const stacks_;
+        const std::size_t count_;
+        const std::size_t stack_size_;
+        slot *free_;
+        std::size_t available_;
+        thread_pool *next_pool_;
+    };
+
+    /// @brief  A thread pool with statically allocated slots.
+    template<const std::size_t STACK_SIZE_BYTES, const std::size_t COUNT>
+    class static_thread_pool : public thread_pool
+    {
+    public:
+        static constexpr std::size_t STACK_SIZE = STACK_SIZE_BYTES * COUNT;
+
+        /// @brief  Constructs a thread pool with all slots free.
+        static_thread_pool()
+            : thread_pool(slots_, &stacks_[0][0], COUNT, STACK_SIZE_BYTES)
+        {
+        }
+
+    private:
+        slot slots_[COUNT];
+        unsigned char stacks_[COUNT][STACK_SIZE_BYTES];
+    };
+}
+
+#endif // __THREADX_THREAD_POOL_H_
@@ -0,0 +1,133 @@
+/**
+ * @file      triple_buffer.h
+ * @brief     ThreadX wait-free triple buffer
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __THREADX_TRIPLE_BUFFER_H_
+#define __THREADX_TRIPLE_BUFFER_H_
+
+#include <atomic>
+#include "threadx/semaphore.h"
+
+namespace threadx
+{
+    /// @brief  A latest-value buffer between a single producer and a single consumer.
+    ///         Both sides are wait-free: the producer never stalls, and the consumer
+    ///         always gets the most recently published value.
+    template<typename T>
+    class triple_buffer
+    {
+    public:
+        using value_type = T;
+
+        /// @brief  Provides the buffer that the producer can fill.
+        /// @return Reference to the producer's buffer
+        inline T& write_buffer()
+        {
+            return buffers_[back_];
+        }
+
+        /// @brief  Publishes the producer's buffer, and swaps it to a recycled one.
+        /// @remark Thread and ISR context callable
+        void publish()
+        {
+            back_ = state_.exchange(back_ | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+
+            // the wakeup is only a hint, the consumer checks the freshness itself
+            if (updated_.get_count() == 0)
+            {
+                updated_.release();
+            }
+        }
+
+        /// @brief  Provides the buffer that the consumer can read.
+        /// @return Reference to the consumer's buffer
+        inline T& read_buffer()
+        {
+            return buffers_[front_];
+        }
+
+        /// @brief  Swaps the consumer's buffer to the latest published one, if any.
+        /// @return true if a new value is available in @ref read_buffer, false otherwise
+        bool update()
+        {
+            if ((state_.load(std::memory_order_relaxed) & FRESH) == 0)
+            {
+                return false;
+            }
+            front_ = state_.exchange(front_, std::memory_order_acq_rel) & INDEX_MASK;
+            return true;
+        }
+
+        /// @brief  Waits until a new value is published, then swaps the consumer's buffer to it.
+        /// @param  rel_time: duration to wait for a new value
+        /// @return true if a new value is available in @ref read_buffer, false if timed out
+        template<class Rep, class Period>
+        bool update_for(const std::chrono::duration<Rep, Period>& rel_time)
+        {
+            const auto deadline = tick_timer::now() + std::chrono::duration_cast<tick_timer::duration>(rel_time);
+            while (!update())
+            {
+                const auto remaining = deadline - tick_timer::now();
+                if ((remaining > std::chrono::duration_cast<tick_timer::duration>(rel_time)) ||
+                    !updated_.try_acquire_for(remaining))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// @brief  Waits indefinitely until a new value is published, then swaps the consumer's buffer to it.
+        void update_wait()
+        {
+            while (!update())
+            {
+                updated_.acquire();
+            }
+        }
+
+        /// @brief  Constructs the buffers with the given initial value.
+        /// @param  init: the initial value of all buffers
+        triple_buffer(const T& init = T())
+            : buffers_ { init, init, init }
+        {
+        }
+
+        // non-copyable
+        triple_buffer(const triple_buffer&) = delete;
+        triple_buffer& operator=(const triple_buffer&) = delete;
+
+    private:
+        static constexpr unsigned char INDEX_MASK = 0x3;
+        static constexpr unsigned char FRESH = 0x4;
+
+        T buffers_[3];
+        unsigned char back_ = 0;
+        unsigned char front_ = 1;
+        std::atomic<unsigned char> state_ { 2 };
+        binary_semaphore updated_;
+    };
+}
+
+#endif // __THREADX_TRIPLE_BUFFER_H_
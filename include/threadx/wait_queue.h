@@ -0,0 +1,169 @@
+/**
+ * @file      wait_queue.h
+ * @brief     ThreadX wait queue for custom synchronizers
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __THREADX_WAIT_QUEUE_H_
+#define __THREADX_WAIT_QUEUE_H_
+
+#include "threadx/cpu.h"
+#include "threadx/tick_timer.h"
+
+namespace threadx
+{
+    /// @brief  A low-level queue of suspended threads, for building custom synchronization
+    ///         primitives. The synchronizer's state is protected by a @ref cpu::critical_section,
+    ///         which is also used to suspend the threads and to wake them up,
+    ///         so each operation takes a single kernel interaction.
+    ///         On SMP ports the critical section is the kernel's inter-core protection,
+    ///         which also guards the preemption control used by the queue.
+    class wait_queue
+    {
+    public:
+        using lock_type = unique_lock<cpu::critical_section>;
+
+        /// @brief  The order in which the waiting threads are woken up.
+        enum class order
+        {
+            fifo,       ///< in the order of their arrival
+            priority,   ///< the highest priority thread first, FIFO within the same priority
+        };
+
+        /// @brief  Suspends the calling thread until it's notified.
+        /// @param  lock: the owned lock of the synchronizer's critical section,
+        ///               it's released while suspended, and owned again upon return
+        /// @return true if notified, false if the wait was aborted
+        inline bool wait(lock_type& lock)
+        {
+            return suspend(lock, infinity);
+        }
+
+        /// @brief  Suspends the calling thread until the predicate is satisfied.
+        /// @param  lock: the owned lock of the synchronizer's critical section
+        /// @param  pred: the condition to wait for, evaluated under the lock
+        template<class Predicate>
+        void wait(lock_type& lock, Predicate pred)
+        {
+            while (!pred())
+            {
+                (void)suspend(lock, infinity);
+            }
+        }
+
+        /// @brief  Suspends the calling thread until it's notified, or the given time duration passes.
+        /// @param  lock:     the owned lock of the synchronizer's critical section,
+        ///                   it's released while suspended, and owned again upon return
+        /// @param  rel_time: duration to wait for the notification
+        /// @return true if notified, false if timed out
+        template<class Rep, class Period>
+        inline bool wait_for(lock_type& lock, const std::chrono::duration<Rep, Period>& rel_time)
+        {
+            return suspend(lock, std::chrono::duration_cast<tick_timer::duration>(rel_time));
+        }
+
+        /// @brief  Suspends the calling thread until the predicate is satisfied, or the given time duration passes.
+        /// @param  lock:     the owned lock of the synchronizer's critical section
+        /// @param  rel_time: duration to wait for the condition
+        /// @param  pred:     the condition to wait for, evaluated under the lock
+        /// @return The final value of the predicate
+        template<class Rep, class Period, class Predicate>
+        bool wait_for(lock_type& lock, const std::chrono::duration<Rep, Period>& rel_time, Predicate pred)
+        {
+            const auto timeout = std::chrono::duration_cast<tick_timer::duration>(rel_time);
+            const auto start = tick_timer::now();
+            while (!pred())
+            {
+                auto remaining = timeout;
+                if (timeout != infinity)
+                {
+                    const auto elapsed = tick_timer::now() - start;
+                    if (elapsed >= timeout)
+                    {
+                        return false;
+                    }
+                    remaining = timeout - elapsed;
+                }
+                (void)suspend(lock, remaining);
+            }
+            return true;
+        }
+
+        /// @brief  Wakes up the first waiting thread.
+        /// @param  lock: the owned lock of the synchronizer's critical section,
+        ///               it's released upon return, letting the woken thread preempt the caller
+        /// @return The number of woken threads
+        /// @remark Thread and ISR context callable
+        inline std::size_t notify_one(lock_type& lock)
+        {
+            return notify(lock, 1);
+        }
+
+        /// @brief  Wakes up a given number of waiting threads.
+        /// @param  lock: the owned lock of the synchronizer's critical section,
+        ///               it's released upon return, letting the woken threads preempt the caller
+        /// @param  n:    the maximum number of threads to wake
+        /// @return The number of woken threads
+        /// @remark Thread and ISR context callable
+        std::size_t notify(lock_type& lock, std::size_t n);
+
+        /// @brief  Wakes up all waiting threads.
+        /// @param  lock: the owned lock of the synchronizer's critical section,
+        ///               it's released upon return, letting the woken threads preempt the caller
+        /// @return The number of woken threads
+        /// @remark Thread and ISR context callable
+        inline std::size_t notify_all(lock_type& lock)
+        {
+            return notify(lock, static_cast<std::size_t>(-1));
+        }
+
+        /// @brief  Function to observe the number of waiting threads.
+        /// @return The number of threads in the queue
+        std::size_t size() const
+        {
+            return count_;
+        }
+
+        /// @brief  Constructs an empty wait queue.
+        /// @param  o: the wake up order of the threads
+        constexpr wait_queue(order o = order::fifo)
+            : head_(nullptr), count_(0), order_(o)
+        {
+        }
+
+        // non-copyable
+        wait_queue(const wait_queue&) = delete;
+        wait_queue& operator=(const wait_queue&) = delete;
+
+    private:
+        bool suspend(lock_type& lock, tick_timer::duration timeout);
+        void enqueue(native::TX_THREAD *t);
+        void remove(native::TX_THREAD *t);
+        static void cleanup(native::TX_THREAD *t, native::ULONG suspension_sequence);
+
+        native::TX_THREAD *head_;
+        std::size_t count_;
+        const order order_;
+    };
+}
+
+#endif // __THREADX_WAIT_QUEUE_H_
@@ -0,0 +1,131 @@
+/**
+ * @file      watchdog.h
+ * @brief     ThreadX software watchdog supervisor
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __THREADX_WATCHDOG_H_
+#define __THREADX_WATCHDOG_H_
+
+#include <atomic>
+#include "threadx/mutex.h"
+#include "threadx/thread.h"
+
+namespace threadx
+{
+    /// @brief  A software watchdog, which supervises the liveness of the registered threads.
+    ///         Each thread has to @ref entry::kick its entry within its deadline,
+    ///         a single supervisor context detects and reports the stalled threads.
+    class watchdog
+    {
+    public:
+        /// @brief  The information reported about a stalled thread.
+        struct report
+        {
+            threadx::thread& thread;
+            const char* name;
+            threadx::thread::state state;
+            std::size_t stack_space;
+            tick_timer::duration since_kick;
+        };
+
+        /// @brief  Function that handles a stalled thread's report.
+        using handler = void (*)(const report& r);
+
+        /// @brief  The registration of a thread to the watchdog.
+        class entry
+        {
+        public:
+            /// @brief  Signals the liveness of the thread.
+            /// @remark Thread and ISR context callable
+            inline void kick()
+            {
+                last_kick_.store(to_ticks(tick_timer::now()), std::memory_order_relaxed);
+            }
+
+            /// @brief  Registers a thread to the watchdog.
+            /// @param  wd:       the supervising watchdog
+            /// @param  t:        the thread to supervise
+            /// @param  deadline: the maximum time allowed between two kicks
+            template<class Rep, class Period>
+            entry(watchdog& wd, thread& t, const std::chrono::duration<Rep, Period>& deadline)
+                : entry(wd, t, std::chrono::duration_cast<tick_timer::duration>(deadline))
+            {
+            }
+
+            entry(watchdog& wd, thread& t, tick_timer::duration deadline);
+
+            /// @brief  Unregisters the thread from the watchdog.
+            ~entry();
+
+            // non-copyable
+            entry(const entry&) = delete;
+            entry& operator=(const entry&) = delete;
+
+        private:
+            friend class watchdog;
+
+            watchdog& watchdog_;
+            thread& thread_;
+            entry* next_;
+            const tick_timer::rep deadline_;
+            std::atomic<tick_timer::rep> last_kick_;
+            tick_timer::rep reported_kick_;
+            bool reported_;
+        };
+
+        /// @brief  Checks the registered threads' deadlines, and reports the stalled ones.
+        ///         A stall is reported once, until the thread kicks its entry again.
+        /// @return The number of currently stalled threads
+        std::size_t check();
+
+        /// @brief  Runs the supervision loop, checking the deadlines periodically.
+        ///         Suitable as a @ref static_thread member function entry point. This function doesn't return.
+        [[noreturn]] void supervise();
+
+        /// @brief  Constructs a watchdog.
+        /// @param  on_stall: the handler of the stalled threads' reports
+        /// @param  period:   the period of the deadline checks in @ref supervise
+        template<class Rep, class Period>
+        watchdog(handler on_stall, const std::chrono::duration<Rep, Period>& period)
+            : watchdog(on_stall, std::chrono::duration_cast<tick_timer::duration>(period))
+        {
+        }
+
+        watchdog(handler on_stall, tick_timer::duration period);
+
+        // non-copyable
+        watchdog(const watchdog&) = delete;
+        watchdog& operator=(const watchdog&) = delete;
+
+    private:
+        void add(entry& e);
+        void remove(entry& e);
+
+        mutex mutex_;
+        entry* entries_;
+        const handler on_stall_;
+        const tick_timer::duration period_;
+    };
+}
+
+#endif // __THREADX_WATCHDOG_H_
@@ -0,0 +1,105 @@
+/**
+ * @file      ceiling_mutex.cpp
+ * @brief     Priority ceiling mutex
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "threadx/ceiling_mutex.h"
+#include "threadx/cpu.h"
+#include "tx_services.h"
+
+#ifndef TX_DISABLE_PREEMPTION_THRESHOLD
+
+using namespace threadx;
+using namespace threadx::native;
+
+namespace
+{
+    UINT raise_threshold(TX_THREAD *t, thread::priority ceiling)
+    {
+        assert((t != nullptr) && !this_cpu::is_in_isr());
+
+        // a thread above the ceiling would violate the protocol
+        assert(ceiling <= t->tx_thread_user_priority);
+
+        // the threshold is only ever raised, an enclosing lock may already be above the ceiling
+        UINT old_threshold = t->tx_thread_user_preempt_threshold;
+        if (ceiling < old_threshold)
+        {
+            UINT result = tx_thread_preemption_change(t, ceiling, &old_threshold);
+            assert(result == TX_SUCCESS);
+        }
+        return old_threshold;
+    }
+
+    void restore_threshold(TX_THREAD *t, UINT threshold)
+    {
+        if (threshold != t->tx_thread_user_preempt_threshold)
+        {
+            UINT old_threshold;
+            UINT result = tx_thread_preemption_change(t, threshold, &old_threshold);
+            assert(result == TX_SUCCESS);
+        }
+    }
+}
+
+void detail::ceiling_lock::lock(thread::priority ceiling)
+{
+    TX_THREAD *t = tx_thread_identify();
+    UINT old_threshold = raise_threshold(t, ceiling);
+
+#ifdef TX_THREAD_SMP_MAX_CORES
+    mutex_.lock();
+#endif
+    previous_threshold_ = old_threshold;
+}
+
+bool detail::ceiling_lock::try_lock(thread::priority ceiling)
+{
+    TX_THREAD *t = tx_thread_identify();
+    UINT old_threshold = raise_threshold(t, ceiling);
+
+#ifdef TX_THREAD_SMP_MAX_CORES
+    // the owner may be running on another core
+    if (!mutex_.try_lock())
+    {
+        restore_threshold(t, old_threshold);
+        return false;
+    }
+#endif
+    previous_threshold_ = old_threshold;
+    return true;
+}
+
+void detail::ceiling_lock::unlock()
+{
+    TX_THREAD *t = tx_thread_identify();
+    UINT new_threshold = previous_threshold_;
+
+#ifdef TX_THREAD_SMP_MAX_CORES
+    mutex_.unlock();
+#endif
+
+    restore_threshold(t, new_threshold);
+}
+
+#endif // TX_DISABLE_PREEMPTION_THRESHOLD
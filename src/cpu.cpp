@@ -24,6 +24,7 @@
  * SOFTWARE.
  */
 #include "threadx/cpu.h"
+#include "tx_services.h"
 
 namespace threadx
 {
@@ -36,18 +37,178 @@ namespace threadx
 using namespace threadx;
 using namespace threadx::native;
 
+#ifdef THREADX_MCPP_CRITICAL_SECTION_STATS
+
+cpu::critical_section::critical_section(const char *file, unsigned line)
+{
+    memset(this, 0, sizeof(*this));
+    file_ = file;
+    line_ = line;
+}
+
+#ifndef THREADX_MCPP_CRITICAL_SECTION_SITES
+// the number of call sites tracked (per core)
+#define THREADX_MCPP_CRITICAL_SECTION_SITES     32
+#endif
+
+namespace
+{
+    constexpr std::size_t SITE_COUNT = THREADX_MCPP_CRITICAL_SECTION_SITES;
+
+    // only accessed with the interrupts of the core masked
+    struct masking_state
+    {
+        UINT depth;
+        ULONG start;
+        const char *file;
+        unsigned line;
+        cpu::critical_section::site_statistics sites[SITE_COUNT];
+    };
+
+    masking_state masking_states[CORE_COUNT];
+
+    inline void masking_begin(const char *file, unsigned line)
+    {
+        masking_state& state = masking_states[this_cpu::get_core_id()];
+        if (state.depth++ == 0)
+        {
+            state.file = file;
+            state.line = line;
+            state.start = this_cpu::get_timestamp();
+        }
+    }
+
+    inline void masking_end()
+    {
+        masking_state& state = masking_states[this_cpu::get_core_id()];
+        if ((--state.depth != 0) || (state.file == nullptr))
+        {
+            return;
+        }
+        const ULONG duration = this_cpu::get_timestamp() - state.start;
+
+        // the sites that don't fit in the table are not tracked,
+        // the file names of different translation units are merged when collected
+        for (auto& s : state.sites)
+        {
+            if (((s.file != state.file) || (s.line != state.line)) && (s.file != nullptr))
+            {
+                continue;
+            }
+            s.file = state.file;
+            s.line = state.line;
+            s.count++;
+            s.total += duration;
+            if (duration > s.max)
+            {
+                s.max = duration;
+            }
+            break;
+        }
+    }
+}
+
+std::size_t cpu::critical_section::get_worst_sites(site_statistics *sites, std::size_t max)
+{
+    std::size_t count = 0;
+    for (auto& state : masking_states)
+    {
+        for (std::size_t i = 0; i < SITE_COUNT; i++)
+        {
+            site_statistics s;
+            {
+                // the statistics of other cores may change meanwhile,
+                // the collection itself isn't recorded
+                critical_section cs(nullptr, 0);
+                lock_guard<critical_section> lock(cs);
+                s = state.sites[i];
+            }
+            if (s.file == nullptr)
+            {
+                break;
+            }
+
+            // merge the same sites of the cores and of the translation units
+            std::size_t pos = 0;
+            while ((pos < count) && ((sites[pos].line != s.line) ||
+                    ((sites[pos].file != s.file) && (strcmp(sites[pos].file, s.file) != 0))))
+            {
+                pos++;
+            }
+            if (pos < count)
+            {
+                sites[pos].count += s.count;
+                sites[pos].total += s.total;
+                if (s.max > sites[pos].max)
+                {
+                    sites[pos].max = s.max;
+                }
+                s = sites[pos];
+                count--;
+                for (; pos < count; pos++)
+                {
+                    sites[pos] = sites[pos + 1];
+                }
+            }
+
+            // insertion in descending order of the longest duration, dropping the least offender
+            pos = count;
+            while ((pos > 0) && (sites[pos - 1].max < s.max))
+            {
+                if (pos < max)
+                {
+                    sites[pos] = sites[pos - 1];
+                }
+                pos--;
+            }
+            if (pos < max)
+            {
+                sites[pos] = s;
+                if (count < max)
+                {
+                    count++;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+void cpu::critical_section::reset_statistics()
+{
+    for (auto& state : masking_states)
+    {
+        critical_section cs(nullptr, 0);
+        lock_guard<critical_section> lock(cs);
+        for (auto& s : state.sites)
+        {
+            s = site_statistics { nullptr, 0, 0, 0, 0 };
+        }
+    }
+}
+
+#else
+
 cpu::critical_section::critical_section()
 {
     memset(this, 0, sizeof(*this));
 }
 
+#endif // THREADX_MCPP_CRITICAL_SECTION_STATS
+
 void cpu::critical_section::lock()
 {
     TX_DISABLE
+#ifdef THREADX_MCPP_CRITICAL_SECTION_STATS
+    masking_begin(file_, line_);
+#endif
 }
 
 void cpu::critical_section::unlock()
 {
+#ifdef THREADX_MCPP_CRITICAL_SECTION_STATS
+    masking_end();
+#endif
     TX_RESTORE
 }
 
@@ -56,3 +217,21 @@ bool this_cpu::is_in_isr()
     auto system_state = TX_THREAD_GET_SYSTEM_STATE();
     return (system_state != 0) && (system_state < TX_INITIALIZE_IN_PROGRESS);
 }
+
+ULONG this_cpu::get_timestamp()
+{
+#ifdef TX_TRACE_TIME_SOURCE
+    return TX_TRACE_TIME_SOURCE;
+#else
+    return tx_time_get();
+#endif
+}
+
+UINT this_cpu::get_core_id()
+{
+#ifdef TX_THREAD_SMP_MAX_CORES
+    return TX_SMP_CORE_ID;
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,319 @@
+/**
+ * @file      cpu_budget.cpp
+ * @brief     CPU time budget enforcement
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "threadx/cpu_budget.h"
+#include "threadx/cpu.h"
+#include "tx_services.h"
+
+using namespace threadx;
+using namespace threadx::native;
+
+namespace
+{
+    // the groups are walked by the tick interrupt, so the list is protected by critical sections
+    cpu_budget *budget_groups = nullptr;
+}
+
+cpu_budget::member::member(cpu_budget& group, thread& t)
+    : group_(group), thread_(t), next_(nullptr), saved_priority_(t.get_priority()),
+      throttled_(false), parked_(false)
+{
+    group_.add(*this);
+}
+
+cpu_budget::member::~member()
+{
+    group_.remove(*this);
+}
+
+void cpu_budget::add(member& m)
+{
+    {
+        cpu::critical_section cs;
+        lock_guard<cpu::critical_section> lock(cs);
+        m.next_ = members_;
+        members_ = &m;
+    }
+
+    // a thread joining a throttled group is throttled right away
+    update();
+}
+
+void cpu_budget::remove(member& m)
+{
+    {
+        cpu::critical_section cs;
+        wait_queue::lock_type lock(cs);
+
+        // the member may be in use by an ongoing update
+        updates_.wait(lock, [this]() { return !updating_; });
+
+        for (member** pm = &members_; *pm != nullptr; pm = &(*pm)->next_)
+        {
+            if (*pm == &m)
+            {
+                *pm = m.next_;
+                break;
+            }
+        }
+        if (!m.throttled_)
+        {
+            return;
+        }
+        m.throttled_ = false;
+
+        if (m.parked_)
+        {
+            // the thread throttled itself, it has to leave the member before it's destroyed
+            updates_.notify_all(lock);
+            lock.lock();
+            updates_.wait(lock, [&m]() { return !m.parked_; });
+            return;
+        }
+        updating_ = true;
+    }
+
+    release(m);
+
+    {
+        cpu::critical_section cs;
+        wait_queue::lock_type lock(cs);
+        updating_ = false;
+        updates_.notify_all(lock);
+    }
+
+    // apply the changes that were made meanwhile
+    update();
+}
+
+void cpu_budget::update()
+{
+    thread *const current = thread::get_current();
+    member *self = nullptr;
+
+    cpu::critical_section cs;
+    wait_queue::lock_type lock(cs);
+
+    // a single context applies the changes at a time, picking up the ones made meanwhile
+    if (updating_)
+    {
+        return;
+    }
+    updating_ = true;
+
+    while (true)
+    {
+        const bool throttled = throttled_;
+        member *m;
+        for (m = members_; (m != nullptr) && (m->throttled_ == throttled); m = m->next_)
+        {
+        }
+        if (m == nullptr)
+        {
+            break;
+        }
+        m->throttled_ = throttled;
+
+        // the calling thread can't suspend itself while it's applying the changes
+        if ((policy_ == policy::suspend) && (&m->thread_ == current))
+        {
+            self = m;
+            continue;
+        }
+        // a parked thread follows its member by itself, once notified
+        if (m->parked_)
+        {
+            continue;
+        }
+
+        // the thread services are called outside of the critical section
+        lock.unlock();
+        if (throttled)
+        {
+            throttle(*m);
+        }
+        else
+        {
+            release(*m);
+        }
+        lock.lock();
+    }
+
+    updating_ = false;
+    updates_.notify_all(lock);
+
+    if (self != nullptr)
+    {
+        lock.lock();
+        park(*self, lock);
+    }
+}
+
+void cpu_budget::park(member& m, wait_queue::lock_type& lock)
+{
+    // instead of suspending itself, the thread waits for the release of its member,
+    // so the release can't get lost before the thread is actually suspended
+    m.parked_ = true;
+    updates_.wait(lock, [&m]() { return !m.throttled_; });
+    m.parked_ = false;
+    updates_.notify_all(lock);
+}
+
+void cpu_budget::throttle(member& m)
+{
+    if (policy_ == policy::demote)
+    {
+        m.saved_priority_ = m.thread_.get_priority();
+        m.thread_.set_priority(demoted_);
+    }
+    else
+    {
+        m.thread_.suspend();
+    }
+}
+
+void cpu_budget::release(member& m)
+{
+    if (policy_ == policy::demote)
+    {
+        m.thread_.set_priority(m.saved_priority_);
+    }
+    else
+    {
+        m.thread_.resume();
+    }
+}
+
+void cpu_budget::on_tick()
+{
+    thread *current = thread::get_current();
+    if (current == nullptr)
+    {
+        return;
+    }
+
+    cpu::critical_section cs;
+    lock_guard<cpu::critical_section> lock(cs);
+    for (cpu_budget *g = budget_groups; g != nullptr; g = g->next_)
+    {
+        for (member *m = g->members_; m != nullptr; m = m->next_)
+        {
+            if (&m->thread_ == current)
+            {
+                g->charge();
+                return;
+            }
+        }
+    }
+}
+
+void cpu_budget::charge()
+{
+    used_ = used_ + 1;
+    if (used_ == budget_)
+    {
+        // the throttling is deferred to the timer context, as it's not ISR callable
+        UINT result = tx_timer_change(&enforce_timer_, 1, 0);
+        assert(result == TX_SUCCESS);
+        result = tx_timer_activate(&enforce_timer_);
+        assert(result == TX_SUCCESS);
+    }
+}
+
+void cpu_budget::enforce_callback(ULONG param)
+{
+    auto *g = reinterpret_cast<cpu_budget*>(param);
+    {
+        cpu::critical_section cs;
+        lock_guard<cpu::critical_section> lock(cs);
+        if (g->throttled_ || (g->used_ < g->budget_))
+        {
+            return;
+        }
+        g->throttled_ = true;
+    }
+    g->update();
+}
+
+void cpu_budget::replenish_callback(ULONG param)
+{
+    auto *g = reinterpret_cast<cpu_budget*>(param);
+    {
+        cpu::critical_section cs;
+        lock_guard<cpu::critical_section> lock(cs);
+        g->used_ = 0;
+        if (!g->throttled_)
+        {
+            return;
+        }
+        g->throttled_ = false;
+    }
+    g->update();
+}
+
+cpu_budget::cpu_budget(tick_timer::duration budget, tick_timer::duration period,
+        policy p, thread::priority demoted)
+    : replenish_timer_(), enforce_timer_(), next_(nullptr), members_(nullptr),
+      budget_(to_ticks(budget)), used_(0), throttled_(false), updating_(false), updates_(), policy_(p), demoted_(demoted)
+{
+    assert((budget_ > 0) && (to_ticks(period) > budget_));
+
+    UINT result = tx_timer_create(&enforce_timer_, const_cast<char*>("cpu_budget"),
+            &cpu_budget::enforce_callback, reinterpret_cast<ULONG>(this), 1, 0, TX_NO_ACTIVATE);
+    assert(result == TX_SUCCESS);
+
+    {
+        cpu::critical_section cs;
+        lock_guard<cpu::critical_section> lock(cs);
+        next_ = budget_groups;
+        budget_groups = this;
+    }
+
+    result = tx_timer_create(&replenish_timer_, const_cast<char*>("cpu_budget"),
+            &cpu_budget::replenish_callback, reinterpret_cast<ULONG>(this),
+            to_ticks(period), to_ticks(period), TX_AUTO_ACTIVATE);
+    assert(result == TX_SUCCESS);
+}
+
+cpu_budget::~cpu_budget()
+{
+    assert(members_ == nullptr);
+
+    UINT result = tx_timer_delete(&replenish_timer_);
+    assert(result == TX_SUCCESS);
+    result = tx_timer_delete(&enforce_timer_);
+    assert(result == TX_SUCCESS);
+
+    cpu::critical_section cs;
+    lock_guard<cpu::critical_section> lock(cs);
+    for (cpu_budget** pg = &budget_groups; *pg != nullptr; pg = &(*pg)->next_)
+    {
+        if (*pg == this)
+        {
+            *pg = next_;
+            break;
+        }
+    }
+}
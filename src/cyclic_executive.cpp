@@ -0,0 +1,159 @@
+/**
+ * @file      cyclic_executive.cpp
+ * @brief     Time-triggered cyclic executive
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "threadx/cyclic_executive.h"
+#include "threadx/thread.h"
+#include "tx_services.h"
+#include <type_traits>
+
+using namespace threadx;
+using namespace threadx::native;
+
+namespace
+{
+    using signed_rep = std::make_signed<tick_timer::rep>::type;
+
+    // the signed distance of the two tick counts, robust to the tick count wrapping around
+    inline signed_rep distance(tick_timer::rep from, tick_timer::rep to)
+    {
+        return static_cast<signed_rep>(to - from);
+    }
+
+    tick_timer::rep gcd(tick_timer::rep a, tick_timer::rep b)
+    {
+        while (b != 0)
+        {
+            const auto r = a % b;
+            a = b;
+            b = r;
+        }
+        return a;
+    }
+}
+
+cyclic_executive::cyclic_executive(slot *table, std::size_t count, overrun_handler on_overrun)
+    : table_(table), count_(count), on_overrun_(on_overrun), frame_(1), frame_end_(0), frame_overruns_(0)
+{
+    assert((table != nullptr) && (count > 0));
+    for (std::size_t i = 0; i < count; i++)
+    {
+        assert((table[i].fn_ != nullptr) && (table[i].period_ > 0));
+
+        // the major frame is the least common multiple of the periods
+        const auto multiple = frame_ / gcd(frame_, table[i].period_);
+        assert(multiple <= (static_cast<tick_timer::rep>(-1) / 2) / table[i].period_);
+        frame_ = multiple * table[i].period_;
+    }
+}
+
+std::size_t cyclic_executive::get_overruns() const
+{
+    std::size_t overruns = 0;
+    for (std::size_t i = 0; i < count_; i++)
+    {
+        overruns += table_[i].stats_.overruns;
+    }
+    return overruns;
+}
+
+void cyclic_executive::dispatch(slot& s)
+{
+    const ULONG start = this_cpu::get_timestamp();
+    s.fn_();
+    const ULONG exec_time = this_cpu::get_timestamp() - start;
+    const auto end = to_ticks(tick_timer::now());
+
+    statistics& stats = s.stats_;
+    stats.runs++;
+    stats.total_time += exec_time;
+    if (exec_time < stats.min_time)
+    {
+        stats.min_time = exec_time;
+    }
+    if (exec_time > stats.max_time)
+    {
+        stats.max_time = exec_time;
+    }
+
+    // the releases stay on the slot's grid, the ones missed by the overrun are skipped
+    s.release_ += s.period_;
+    if (distance(s.release_, end) > 0)
+    {
+        const tick_timer::duration overrun { end - s.release_ };
+        while (distance(s.release_, end) > 0)
+        {
+            s.release_ += s.period_;
+            stats.overruns++;
+        }
+        if (on_overrun_ != nullptr)
+        {
+            on_overrun_(s, overrun);
+        }
+    }
+}
+
+void cyclic_executive::run()
+{
+    const auto origin = to_ticks(tick_timer::now());
+    for (std::size_t i = 0; i < count_; i++)
+    {
+        table_[i].release_ = origin + table_[i].offset_;
+    }
+    frame_end_ = origin + frame_;
+
+    while (true)
+    {
+        const auto now = to_ticks(tick_timer::now());
+
+        // the slots are dispatched in table order within the same tick
+        signed_rep next = distance(now, table_[0].release_);
+        slot *due = &table_[0];
+        for (std::size_t i = 1; i < count_; i++)
+        {
+            const auto until_release = distance(now, table_[i].release_);
+            if (until_release < next)
+            {
+                next = until_release;
+                due = &table_[i];
+            }
+        }
+
+        // once the next release belongs to a later frame, the releases of the current one are done
+        while (distance(frame_end_, due->release_) >= 0)
+        {
+            if (distance(frame_end_, now) > 0)
+            {
+                frame_overruns_++;
+            }
+            frame_end_ += frame_;
+        }
+
+        if (next > 0)
+        {
+            this_thread::sleep_for(tick_timer::duration(static_cast<tick_timer::rep>(next)));
+        }
+        dispatch(*due);
+    }
+}
@@ -0,0 +1,148 @@
+/**
+ * @file      deferred_log.cpp
+ * @brief     Deferred binary logging
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "threadx/deferred_log.h"
+#include "threadx/thread.h"
+#include <atomic>
+
+using namespace threadx;
+using namespace threadx::native;
+
+#ifndef THREADX_MCPP_LOG_SIZE
+// the size of the log ring buffer (per core) in words
+#define THREADX_MCPP_LOG_SIZE       512
+#endif
+
+namespace
+{
+    constexpr std::size_t LOG_SIZE = THREADX_MCPP_LOG_SIZE;
+    static_assert((LOG_SIZE & (LOG_SIZE - 1)) == 0, "The log size must be a power of two.");
+
+    // the first word of a record identifies it and holds its size,
+    // it's written last, committing the record
+    constexpr deferred_log::word RECORD_MAGIC = 0x4C470000;
+    constexpr deferred_log::word RECORD_SIZE_MASK = 0xFFFF;
+
+    // the stream header precedes the records of each drain, the host determines the byte order
+    // from the mark, and the size of the multi-word values from the layout word
+    constexpr deferred_log::word STREAM_MAGIC = 0x4C530000;
+    constexpr deferred_log::word BYTE_ORDER_MARK = 0x01020304;
+    constexpr deferred_log::word STREAM_HEADER[] = {
+        STREAM_MAGIC | 3,
+        BYTE_ORDER_MARK,
+        sizeof(std::uintptr_t) | (sizeof(long) << 8),
+    };
+
+    struct log_ring
+    {
+        std::atomic<std::uint32_t> head;
+        std::atomic<std::uint32_t> tail;
+        std::atomic<deferred_log::word> words[LOG_SIZE];
+    };
+
+    // each core writes its own ring, which keeps the contention local
+    log_ring log_rings[CORE_COUNT];
+
+    std::atomic<std::size_t> log_dropped { 0 };
+
+    inline log_ring& this_ring()
+    {
+        return log_rings[this_cpu::get_core_id()];
+    }
+}
+
+bool deferred_log::commit(const char *format, const word *args, std::size_t count)
+{
+    log_ring& ring = this_ring();
+    const std::uint32_t size = HEADER_WORDS + count;
+
+    // reserve the space of the record, concurrent writers (including ISRs) get consecutive spaces
+    std::uint32_t head = ring.head.load(std::memory_order_relaxed);
+    do
+    {
+        if ((head + size - ring.tail.load(std::memory_order_acquire)) > LOG_SIZE)
+        {
+            log_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    while (!ring.head.compare_exchange_weak(head, head + size, std::memory_order_relaxed));
+
+    word header[HEADER_WORDS - 1];
+    detail::log_encode(header, reinterpret_cast<std::uintptr_t>(format),
+            static_cast<word>(this_cpu::get_timestamp()),
+            this_cpu::is_in_isr() ? thread::id(0) : this_thread::get_id());
+    for (std::size_t i = 0; i < (HEADER_WORDS - 1); i++)
+    {
+        ring.words[(head + 1 + i) % LOG_SIZE].store(header[i], std::memory_order_relaxed);
+    }
+    for (std::size_t i = 0; i < count; i++)
+    {
+        ring.words[(head + HEADER_WORDS + i) % LOG_SIZE].store(args[i], std::memory_order_relaxed);
+    }
+    ring.words[head % LOG_SIZE].store(RECORD_MAGIC | size, std::memory_order_release);
+    return true;
+}
+
+std::size_t deferred_log::drain(sink s)
+{
+    std::size_t records = 0;
+    for (log_ring& ring : log_rings)
+    {
+        std::uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+        while (true)
+        {
+            // an uncommitted record holds back the rest, until its writer completes it
+            const word header = ring.words[tail % LOG_SIZE].load(std::memory_order_acquire);
+            if ((header & ~RECORD_SIZE_MASK) != RECORD_MAGIC)
+            {
+                break;
+            }
+
+            word record[HEADER_WORDS + MAX_ARG_WORDS];
+            const std::uint32_t size = header & RECORD_SIZE_MASK;
+            for (std::uint32_t i = 0; i < size; i++)
+            {
+                // the space is cleared for the records to come
+                record[i] = ring.words[(tail + i) % LOG_SIZE].exchange(0, std::memory_order_relaxed);
+            }
+            tail += size;
+            ring.tail.store(tail, std::memory_order_release);
+
+            if (records == 0)
+            {
+                s(STREAM_HEADER, sizeof(STREAM_HEADER) / sizeof(STREAM_HEADER[0]));
+            }
+            s(record, size);
+            records++;
+        }
+    }
+    return records;
+}
+
+std::size_t deferred_log::get_dropped()
+{
+    return log_dropped.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,136 @@
+/**
+ * @file      io_completion_port.cpp
+ * @brief     Asynchronous I/O completion port
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "threadx/io_completion_port.h"
+#include "tx_services.h"
+
+using namespace threadx;
+using namespace threadx::native;
+
+void io_completion_port::submit(io_operation& op)
+{
+    cpu::critical_section cs;
+    lock_guard<cpu::critical_section> lock(cs);
+
+    assert(!op.pending_);
+    op.pending_ = true;
+    op.next_ = nullptr;
+    outstanding_++;
+}
+
+void io_completion_port::complete(io_operation& op, result_type result)
+{
+    cpu::critical_section cs;
+    wait_queue::lock_type lock(cs);
+
+    assert(op.pending_);
+    op.result_ = result;
+    op.next_ = nullptr;
+    if (tail_ == nullptr)
+    {
+        head_ = &op;
+    }
+    else
+    {
+        tail_->next_ = &op;
+    }
+    tail_ = &op;
+
+    // the completions are reaped in batches, a single reaper is enough to take them
+    (void)reapers_.notify_one(lock);
+}
+
+io_operation *io_completion_port::take(std::size_t max, tick_timer::duration timeout)
+{
+    assert(max > 0);
+
+    cpu::critical_section cs;
+    wait_queue::lock_type lock(cs);
+
+    if (!reapers_.wait_for(lock, timeout, [this]() { return head_ != nullptr; }))
+    {
+        return nullptr;
+    }
+
+    // detach a chain of completions from the front of the queue
+    io_operation *first = head_;
+    io_operation *last = head_;
+    std::size_t count = 1;
+    while ((count < max) && (last->next_ != nullptr))
+    {
+        last = last->next_;
+        count++;
+    }
+    head_ = last->next_;
+    last->next_ = nullptr;
+    if (head_ == nullptr)
+    {
+        tail_ = nullptr;
+    }
+    outstanding_ -= count;
+
+    // pass on the remaining completions to another reaper
+    if (head_ != nullptr)
+    {
+        (void)reapers_.notify_one(lock);
+    }
+    return first;
+}
+
+std::size_t io_completion_port::get(io_operation *ops[], std::size_t max, tick_timer::duration timeout)
+{
+    std::size_t count = 0;
+    for (io_operation *op = take(max, timeout); op != nullptr; count++)
+    {
+        // the operation may be resubmitted as soon as it's no longer pending
+        io_operation *next = op->next_;
+        op->pending_ = false;
+        ops[count] = op;
+        op = next;
+    }
+    return count;
+}
+
+std::size_t io_completion_port::dispatch(std::size_t max)
+{
+    std::size_t count = 0;
+    for (io_operation *op = take(max, infinity); op != nullptr; count++)
+    {
+        // the operation may be resubmitted by its handler
+        io_operation *next = op->next_;
+        op->pending_ = false;
+        op->handler_(*op);
+        op = next;
+    }
+    return count;
+}
+
+void io_completion_port::serve(std::size_t batch)
+{
+    while (true)
+    {
+        (void)dispatch(batch);
+    }
+}
@@ -0,0 +1,146 @@
+/**
+ * @file      lazy.cpp
+ * @brief     ThreadX thread-safe lazy initialization
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "threadx/lazy.h"
+#include "threadx/cpu.h"
+#include "threadx/scheduler.h"
+#include "threadx/wait_queue.h"
+#include "tx_services.h"
+
+using namespace threadx;
+using namespace threadx::native;
+
+namespace
+{
+    // the threads waiting for a concurrent initialization, contention is rare,
+    // so a single queue serves all initializations
+    wait_queue once_waiters;
+}
+
+bool detail::once_begin(std::atomic<unsigned char>& state)
+{
+    unsigned char expected = once_uninitialized;
+    if (state.compare_exchange_strong(expected, once_busy,
+            std::memory_order_acquire, std::memory_order_acquire))
+    {
+        return true;
+    }
+    if (expected == once_done)
+    {
+        return false;
+    }
+
+    // without a running scheduler, or in ISR context there is nothing to wait for
+    assert((scheduler::get_state() == scheduler::state::running) && !this_cpu::is_in_isr());
+
+    cpu::critical_section cs;
+    wait_queue::lock_type lock(cs);
+    while (true)
+    {
+        expected = state.load(std::memory_order_relaxed);
+        if (expected == once_done)
+        {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return false;
+        }
+        if ((expected == once_uninitialized) &&
+            state.compare_exchange_strong(expected, once_busy,
+                std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            return true;
+        }
+        once_waiters.wait(lock);
+    }
+}
+
+void detail::once_end(std::atomic<unsigned char>& state, bool success)
+{
+    cpu::critical_section cs;
+    wait_queue::lock_type lock(cs);
+
+    state.store(success ? once_done : once_uninitialized, std::memory_order_release);
+
+    // the waiters of other initializations go back to waiting
+    once_waiters.notify_all(lock);
+}
+
+#ifdef THREADX_MCPP_CXA_GUARD
+
+namespace
+{
+    #ifdef __ARM_EABI__
+    // 32-bit guard, the least significant bit marks the completed initialization,
+    // so the byte holding it depends on the byte order
+    using cxa_guard = int;
+    #if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    constexpr std::size_t DONE_BYTE = sizeof(cxa_guard) - 1;
+    constexpr std::size_t STATE_BYTE = 0;
+    #else
+    constexpr std::size_t DONE_BYTE = 0;
+    constexpr std::size_t STATE_BYTE = 1;
+    #endif
+    #else
+    // 64-bit guard, the first byte marks the completed initialization
+    using cxa_guard = long long;
+    constexpr std::size_t DONE_BYTE = 0;
+    constexpr std::size_t STATE_BYTE = 1;
+    #endif
+
+    // the done byte is checked by the compiler's inlined fast path,
+    // another byte holds the state of the initialization
+    inline std::atomic<unsigned char>& guard_done(cxa_guard *g)
+    {
+        return *reinterpret_cast<std::atomic<unsigned char>*>(reinterpret_cast<unsigned char*>(g) + DONE_BYTE);
+    }
+
+    inline std::atomic<unsigned char>& guard_state(cxa_guard *g)
+    {
+        return *reinterpret_cast<std::atomic<unsigned char>*>(reinterpret_cast<unsigned char*>(g) + STATE_BYTE);
+    }
+}
+
+// ThreadX aware thread-safe initialization of function-local statics
+
+extern "C" int __cxa_guard_acquire(cxa_guard *g)
+{
+    if (guard_done(g).load(std::memory_order_acquire) != 0)
+    {
+        return 0;
+    }
+    return detail::once_begin(guard_state(g)) ? 1 : 0;
+}
+
+extern "C" void __cxa_guard_release(cxa_guard *g)
+{
+    guard_done(g).store(1, std::memory_order_release);
+    detail::once_end(guard_state(g), true);
+}
+
+extern "C" void __cxa_guard_abort(cxa_guard *g)
+{
+    detail::once_end(guard_state(g), false);
+}
+
+#endif // THREADX_MCPP_CXA_GUARD
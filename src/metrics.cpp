@@ -0,0 +1,136 @@
+/**
+ * @file      metrics.cpp
+ * @brief     Lock-free metrics registry
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "threadx/metrics.h"
+
+using namespace threadx;
+using namespace threadx::native;
+
+namespace
+{
+    metric *metrics_list = nullptr;
+}
+
+metric::metric(const char *name, kind k)
+    : name_(name), kind_(k), next_(nullptr)
+{
+    // the new metric is appended, so the list follows the order of registration
+    cpu::critical_section cs;
+    lock_guard<cpu::critical_section> lock(cs);
+    metric **pm = &metrics_list;
+    while (*pm != nullptr)
+    {
+        pm = &(*pm)->next_;
+    }
+    *pm = this;
+}
+
+metric::~metric()
+{
+    cpu::critical_section cs;
+    lock_guard<cpu::critical_section> lock(cs);
+    for (metric **pm = &metrics_list; *pm != nullptr; pm = &(*pm)->next_)
+    {
+        if (*pm == this)
+        {
+            *pm = next_;
+            break;
+        }
+    }
+}
+
+const metric* metric::get_first()
+{
+    return metrics_list;
+}
+
+counter::value_type counter::get_value() const
+{
+    value_type value = 0;
+    for (auto& s : shards_)
+    {
+        value += s.value.load(std::memory_order_relaxed);
+    }
+    return value;
+}
+
+void histogram::get_snapshot(snapshot& s) const
+{
+    for (unsigned b = 0; b < BUCKET_COUNT; b++)
+    {
+        count_type count = 0;
+        for (auto& shard : shards_)
+        {
+            count += shard.buckets[b].load(std::memory_order_relaxed);
+        }
+        s.buckets[b] = count;
+    }
+}
+
+histogram::value_type histogram::bucket_upper_bound(unsigned bucket)
+{
+    if (bucket < SUB_BUCKETS)
+    {
+        return bucket;
+    }
+    const unsigned msb = (bucket >> SUB_BUCKET_BITS) + SUB_BUCKET_BITS - 1;
+    const unsigned shift = msb - SUB_BUCKET_BITS;
+    const std::uint64_t lower = (static_cast<std::uint64_t>(SUB_BUCKETS | (bucket & (SUB_BUCKETS - 1)))) << shift;
+    return static_cast<value_type>(lower + (1ull << shift) - 1);
+}
+
+void histogram::snapshot::merge(const snapshot& other)
+{
+    for (unsigned b = 0; b < BUCKET_COUNT; b++)
+    {
+        buckets[b] += other.buckets[b];
+    }
+}
+
+histogram::count_type histogram::snapshot::get_count() const
+{
+    count_type count = 0;
+    for (auto c : buckets)
+    {
+        count += c;
+    }
+    return count;
+}
+
+histogram::value_type histogram::snapshot::get_quantile(float q) const
+{
+    const count_type total = get_count();
+    const count_type rank = static_cast<count_type>(q * total);
+    count_type count = 0;
+    for (unsigned b = 0; b < BUCKET_COUNT; b++)
+    {
+        count += buckets[b];
+        if ((count > rank) || ((count == total) && (count > 0)))
+        {
+            return bucket_upper_bound(b);
+        }
+    }
+    return 0;
+}
@@ -24,6 +24,7 @@
  * SOFTWARE.
  */
 #include "threadx/mutex.h"
+#include "tx_services.h"
 
 using namespace threadx;
 using namespace threadx::native;
@@ -45,8 +46,27 @@ thread *mutex::get_locking_thread() const
     return reinterpret_cast<thread*>(tx_mutex_owner);
 }
 
+void mutex::unlock_all()
+{
+    TX_THREAD *self = tx_thread_identify();
+    assert((tx_mutex_owner == nullptr) || (tx_mutex_owner == self));
+
+    // the last put may hand the mutex over to a waiting thread
+    while (tx_mutex_owner == self)
+    {
+        auto result = tx_mutex_put(this);
+        assert(result == TX_SUCCESS);
+    }
+}
+
 mutex::mutex()
 {
     static const bool priority_inheritance = true;
     tx_mutex_create(this, const_cast<char*>(DEFAULT_NAME), priority_inheritance ? TX_INHERIT : TX_NO_INHERIT);
 }
+
+mutex::~mutex()
+{
+    auto result = tx_mutex_delete(this);
+    assert(result == TX_SUCCESS);
+}
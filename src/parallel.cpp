@@ -0,0 +1,101 @@
+/**
+ * @file      parallel.cpp
+ * @brief     ThreadX parallel algorithms over a worker team
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "threadx/parallel.h"
+#include "tx_services.h"
+
+using namespace threadx;
+using namespace threadx::native;
+
+void worker_team::worker_main(worker *w)
+{
+    while (true)
+    {
+        w->start.acquire();
+        w->team->execute(w->index);
+        w->team->done_.release();
+    }
+}
+
+void worker_team::execute(std::size_t participant)
+{
+    if (partition_ == partition::fixed)
+    {
+        const auto length = last_ - first_;
+        const auto first = first_ + (length * participant) / size();
+        const auto last = first_ + (length * (participant + 1)) / size();
+        if (first < last)
+        {
+            func_(context_, first, last, participant);
+        }
+    }
+    else
+    {
+        while (true)
+        {
+            const auto first = next_.fetch_add(grain_, std::memory_order_relaxed);
+            if (first >= last_)
+            {
+                break;
+            }
+            const auto last = ((last_ - first) > grain_) ? (first + grain_) : last_;
+            func_(context_, first, last, participant);
+        }
+    }
+}
+
+void worker_team::run(std::size_t first, std::size_t last, std::size_t grain, partition p,
+        chunk_function func, void *context)
+{
+    lock_guard<mutex> lock(mutex_);
+
+    first_ = first;
+    last_ = last;
+    grain_ = (grain > 0) ? grain : 1;
+    partition_ = p;
+    func_ = func;
+    context_ = context;
+    next_.store(first, std::memory_order_relaxed);
+
+    for (std::size_t i = 0; i < workers_count_; i++)
+    {
+        workers_[i].start.release();
+    }
+
+    // the caller takes part as the last participant
+    execute(workers_count_);
+
+    // barrier: wait for all workers to finish their part
+    for (std::size_t i = 0; i < workers_count_; i++)
+    {
+        done_.acquire();
+    }
+}
+
+worker_team::worker_team(worker *workers, std::size_t count)
+    : workers_(workers), workers_count_(count), done_(0), next_(0),
+      first_(0), last_(0), grain_(1), partition_(partition::dynamic), func_(nullptr), context_(nullptr)
+{
+}
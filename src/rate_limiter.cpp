@@ -0,0 +1,122 @@
+/**
+ * @file      rate_limiter.cpp
+ * @brief     ThreadX token bucket rate limiter
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "threadx/rate_limiter.h"
+#include "threadx/thread.h"
+#include "tx_services.h"
+
+using namespace threadx;
+using namespace threadx::native;
+
+void rate_limiter::refill(tick_timer::rep now)
+{
+    auto last = last_refill_.load(std::memory_order_relaxed);
+    auto periods = (now - last) / period_;
+    if (periods == 0)
+    {
+        return;
+    }
+
+    // only the context that advances the refill time adds the tokens,
+    // the remainder of the current period is kept for the next refill
+    if (!last_refill_.compare_exchange_strong(last, last + periods * period_,
+            std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    const count_type added = (periods > (capacity_ / tokens_)) ? capacity_ : (periods * tokens_);
+    auto count = count_.load(std::memory_order_relaxed);
+    count_type desired;
+    do
+    {
+        desired = ((capacity_ - count) < added) ? capacity_ : (count + added);
+    }
+    while (!count_.compare_exchange_weak(count, desired, std::memory_order_relaxed));
+}
+
+bool rate_limiter::try_acquire(count_type n)
+{
+    refill(to_ticks(tick_timer::now()));
+
+    auto count = count_.load(std::memory_order_relaxed);
+    do
+    {
+        if (count < n)
+        {
+            return false;
+        }
+    }
+    while (!count_.compare_exchange_weak(count, count - n, std::memory_order_relaxed));
+    return true;
+}
+
+rate_limiter::count_type rate_limiter::get_count()
+{
+    refill(to_ticks(tick_timer::now()));
+    return count_.load(std::memory_order_relaxed);
+}
+
+bool rate_limiter::get(count_type n, tick_timer::duration timeout)
+{
+    assert(n <= capacity_); // else the request can never be satisfied
+
+    const auto start = to_ticks(tick_timer::now());
+    while (!try_acquire(n))
+    {
+        const auto now = to_ticks(tick_timer::now());
+        const auto count = count_.load(std::memory_order_relaxed);
+        if (count >= n)
+        {
+            // tokens were refilled in the meantime
+            continue;
+        }
+
+        // sleep exactly until the bucket is refilled with the missing tokens
+        const auto periods = (n - count + tokens_ - 1) / tokens_;
+        const auto elapsed = now - last_refill_.load(std::memory_order_relaxed);
+        if (elapsed >= (periods * period_))
+        {
+            continue;
+        }
+        const auto wait = (periods * period_) - elapsed;
+
+        // other contexts can only take tokens, so give up early if the deadline is too close
+        if ((timeout != infinity) &&
+            (((now - start) >= to_ticks(timeout)) || (wait > (to_ticks(timeout) - (now - start)))))
+        {
+            return false;
+        }
+        this_thread::sleep_for(tick_timer::duration(wait));
+    }
+    return true;
+}
+
+rate_limiter::rate_limiter(count_type capacity, count_type tokens, tick_timer::duration period)
+    : capacity_(capacity), tokens_(tokens), period_(to_ticks(period)),
+      count_(capacity), last_refill_(to_ticks(tick_timer::now()))
+{
+    assert((capacity > 0) && (tokens > 0) && (to_ticks(period) > 0));
+}
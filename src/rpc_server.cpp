@@ -0,0 +1,101 @@
+/**
+ * @file      rpc_server.cpp
+ * @brief     Synchronous RPC server with priority donation
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "threadx/rpc_server.h"
+#include "tx_services.h"
+
+using namespace threadx;
+using namespace threadx::native;
+
+detail::rpc_queue::rpc_queue()
+    : mutex_(), requests_(0), pending_(nullptr), server_(nullptr), base_priority_()
+{
+}
+
+void detail::rpc_queue::call(rpc_slot& slot, const void *request, void *response)
+{
+    slot.request = request;
+    slot.response = response;
+    slot.priority = thread::get_current()->get_priority();
+    {
+        lock_guard<mutex> lock(mutex_);
+
+        // lower priority values are more urgent, equal priorities are served in FIFO order
+        rpc_slot **pos = &pending_;
+        while ((*pos != nullptr) && ((*pos)->priority <= slot.priority))
+        {
+            pos = &(*pos)->next;
+        }
+        slot.next = *pos;
+        *pos = &slot;
+
+        // donate the caller's priority to the server, whether it's busy or idle
+        if ((server_ != nullptr) && (slot.priority < server_->get_priority()))
+        {
+            server_->set_priority(slot.priority);
+        }
+    }
+    requests_.release();
+    slot.done.acquire();
+}
+
+detail::rpc_slot& detail::rpc_queue::get()
+{
+    {
+        lock_guard<mutex> lock(mutex_);
+        if (server_ == nullptr)
+        {
+            server_ = thread::get_current();
+            base_priority_ = server_->get_priority();
+        }
+        assert(server_ == thread::get_current());
+
+        // drop the donated priority while idle
+        if ((pending_ == nullptr) && (server_->get_priority() != base_priority_))
+        {
+            server_->set_priority(base_priority_);
+        }
+    }
+    requests_.acquire();
+
+    lock_guard<mutex> lock(mutex_);
+    rpc_slot& slot = *pending_;
+    pending_ = slot.next;
+    slot.next = nullptr;
+
+    // serve at the priority of the request, but never below the server's own
+    // (the lower value is the more urgent)
+    thread::priority prio = (slot.priority < base_priority_) ? slot.priority : base_priority_;
+    if (server_->get_priority() != prio)
+    {
+        server_->set_priority(prio);
+    }
+    return slot;
+}
+
+void detail::rpc_queue::put(rpc_slot& slot)
+{
+    slot.done.release();
+}
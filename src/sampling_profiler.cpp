@@ -0,0 +1,118 @@
+/**
+ * @file      sampling_profiler.cpp
+ * @brief     Tick driven sampling profiler
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "threadx/sampling_profiler.h"
+#include "tx_services.h"
+#include <atomic>
+
+using namespace threadx;
+using namespace threadx::native;
+
+#ifndef THREADX_MCPP_PROFILER_SIZE
+// the size of the sample buffer (per core) in samples
+#define THREADX_MCPP_PROFILER_SIZE  256
+#endif
+
+namespace
+{
+    constexpr std::size_t PROFILER_SIZE = THREADX_MCPP_PROFILER_SIZE;
+    static_assert((PROFILER_SIZE & (PROFILER_SIZE - 1)) == 0, "The profiler size must be a power of two.");
+
+    // the tick interrupt is the only producer of each core's buffer
+    struct sample_ring
+    {
+        std::atomic<std::uint32_t> head;
+        std::atomic<std::uint32_t> tail;
+        sampling_profiler::sample samples[PROFILER_SIZE];
+    };
+
+    sample_ring sample_rings[CORE_COUNT];
+
+    std::atomic<bool> profiler_enabled { false };
+    std::atomic<std::size_t> profiler_dropped { 0 };
+}
+
+void sampling_profiler::on_tick(const void *pc)
+{
+    if (!profiler_enabled.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    sample_ring& ring = sample_rings[this_cpu::get_core_id()];
+    const std::uint32_t head = ring.head.load(std::memory_order_relaxed);
+    if ((head - ring.tail.load(std::memory_order_acquire)) == PROFILER_SIZE)
+    {
+        profiler_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // called from ISR context, the interrupted thread is identified
+    sample& s = ring.samples[head % PROFILER_SIZE];
+    s.thread = static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(tx_thread_identify()));
+    s.pc = static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(pc));
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+void sampling_profiler::start()
+{
+    profiler_enabled.store(true, std::memory_order_relaxed);
+}
+
+void sampling_profiler::stop()
+{
+    profiler_enabled.store(false, std::memory_order_relaxed);
+}
+
+std::size_t sampling_profiler::drain(sink s)
+{
+    std::size_t count = 0;
+    for (sample_ring& ring : sample_rings)
+    {
+        std::uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+        const std::uint32_t head = ring.head.load(std::memory_order_acquire);
+
+        // the samples are shipped in at most two contiguous batches
+        while (tail != head)
+        {
+            const std::uint32_t index = tail % PROFILER_SIZE;
+            std::uint32_t batch = head - tail;
+            if (batch > (PROFILER_SIZE - index))
+            {
+                batch = PROFILER_SIZE - index;
+            }
+            s(&ring.samples[index], batch);
+            tail += batch;
+            count += batch;
+            ring.tail.store(tail, std::memory_order_release);
+        }
+    }
+    return count;
+}
+
+std::size_t sampling_profiler::get_dropped()
+{
+    return profiler_dropped.load(std::memory_order_relaxed);
+}
@@ -25,6 +25,7 @@
  */
 #include "threadx/scheduler.h"
 #include "threadx/cpu.h"
+#include "tx_services.h"
 
 namespace threadx
 {
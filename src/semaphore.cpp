@@ -24,7 +24,16 @@
  * SOFTWARE.
  */
 #include "threadx/semaphore.h"
+#include "threadx/cpu.h"
+#include "tx_services.h"
 
+namespace threadx
+{
+    namespace native
+    {
+        #include "tx_thread.h"
+    }
+}
 using namespace threadx;
 using namespace threadx::native;
 
@@ -51,6 +60,38 @@ semaphore::count_type semaphore::get_count() const
     return tx_semaphore_count;
 }
 
+void semaphore::reset(count_type desired)
+{
+    bool woken = false;
+    {
+        cpu::critical_section cs;
+        lock_guard<cpu::critical_section> lock(cs);
+
+        // waiting threads imply that the count is zero, hand the new count over to them,
+        // holding off preemption until the count is settled
+        _tx_thread_preempt_disable++;
+        while ((desired > 0) && (tx_semaphore_suspended_count > 0))
+        {
+            auto result = tx_semaphore_put(this);
+            assert(result == TX_SUCCESS);
+            desired--;
+            woken = true;
+        }
+        tx_semaphore_count = desired;
+        _tx_thread_preempt_disable--;
+    }
+    if (woken)
+    {
+        _tx_thread_system_preempt_check();
+    }
+}
+
+semaphore::~semaphore()
+{
+    auto result = tx_semaphore_delete(this);
+    assert(result == TX_SUCCESS);
+}
+
 semaphore::semaphore(count_type max, count_type desired, const char* name)
 {
     auto result = tx_semaphore_create(this, const_cast<char*>(name), desired);
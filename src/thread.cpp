@@ -25,12 +25,21 @@
  */
 #include "threadx/thread.h"
 #include "threadx/semaphore.h"
+#include "threadx/cpu.h"
+#include "threadx/thread_pool.h"
+#include "threadx/thread_group.h"
+#include "tx_services.h"
 
 using namespace threadx;
 using namespace threadx::native;
 
 thread::~thread()
 {
+    // a thread that never started may still be deferred by a thread group
+    if (tx_thread_state == TX_SUSPENDED)
+    {
+        thread_group::forget(*this);
+    }
     if (tx_thread_state != TX_COMPLETED)
     {
         auto result = tx_thread_terminate(this);
@@ -42,6 +51,19 @@ thread::~thread()
 
 #ifndef TX_DISABLE_NOTIFY_CALLBACKS
 
+    namespace
+    {
+        // entry_exit_param_ markers of the thread's observation, besides
+        // nullptr (not observed) and the joining context's semaphore
+        char detached_marker;
+        char exited_marker;
+        char reclaimed_marker;
+
+        void *const DETACHED = &detached_marker;
+        void *const EXITED = &exited_marker;        // exited before being joined or detached
+        void *const RECLAIMED = &reclaimed_marker;  // exited, and joined or detached
+    }
+
     void thread::set_entry_exit_callback(entry_exit_callback func, void* param)
     {
         if (TX_SUCCESS == tx_thread_entry_exit_notify(this, reinterpret_cast<void(*)(TX_THREAD *, unsigned)>(func)))
@@ -67,32 +89,87 @@ thread::~thread()
 
     bool thread::joinable() const
     {
-        auto state = get_state();
-        return (state != state::completed) && (state != state::terminated) && (nullptr == get_entry_exit_param());
+        // in line with join(), an exited thread remains joinable until it's observed
+        auto *observer = get_entry_exit_param();
+        return (observer == nullptr) || (observer == EXITED);
     }
 
-    void thread::join_exit_callback(thread *t, UINT id)
+    void thread::exit_callback(thread *t, UINT id)
     {
-        if (id == TX_THREAD_EXIT)
+        if (id != TX_THREAD_EXIT)
         {
-            auto *exit_cond = reinterpret_cast<semaphore*>(t->get_entry_exit_param());
+            return;
+        }
+
+        void *observer;
+        {
+            cpu::critical_section cs;
+            lock_guard<cpu::critical_section> lock(cs);
+
+            observer = t->get_entry_exit_param();
+            t->entry_exit_param_ = (observer == nullptr) ? EXITED : RECLAIMED;
+        }
 
-            exit_cond->release();
+        if (observer != nullptr)
+        {
+            // the resources are returned before the joining context continues
+            thread_pool::reclaim(t);
+            if (observer != DETACHED)
+            {
+                reinterpret_cast<semaphore*>(observer)->release();
+            }
         }
+        // else not observed yet, the resources are kept until joined or detached
     }
 
     void thread::join()
     {
-        assert(joinable()); // else invalid_argument
         assert(this->get_id() != this_thread::get_id()); // else resource_deadlock_would_occur
 
         binary_semaphore exit_cond;
-        set_entry_exit_callback(&thread::join_exit_callback, reinterpret_cast<void*>(&exit_cond));
+        bool exited;
+        {
+            cpu::critical_section cs;
+            lock_guard<cpu::critical_section> lock(cs);
+
+            auto *observer = get_entry_exit_param();
+            assert((observer == nullptr) || (observer == EXITED)); // else invalid_argument
+
+            exited = (observer == EXITED);
+            entry_exit_param_ = exited ? RECLAIMED : reinterpret_cast<void*>(&exit_cond);
+        }
 
-        // wait for signal from thread exit
-        exit_cond.acquire();
+        if (exited)
+        {
+            thread_pool::reclaim(this);
+        }
+        else
+        {
+            // wait for signal from thread exit
+            exit_cond.acquire();
+        }
 
-        // signal received, thread is deleted, return
+        // signal received, thread is finished, return
+    }
+
+    void thread::detach()
+    {
+        bool exited;
+        {
+            cpu::critical_section cs;
+            lock_guard<cpu::critical_section> lock(cs);
+
+            auto *observer = get_entry_exit_param();
+            assert((observer == nullptr) || (observer == EXITED)); // else invalid_argument
+
+            exited = (observer == EXITED);
+            entry_exit_param_ = exited ? RECLAIMED : DETACHED;
+        }
+
+        if (exited)
+        {
+            thread_pool::reclaim(this);
+        }
     }
 
 #endif // !TX_DISABLE_NOTIFY_CALLBACKS
@@ -128,6 +205,12 @@ const char *thread::get_name()
     return const_cast<const char*>(tx_thread_name);
 }
 
+std::size_t thread::get_stack_space() const
+{
+    // all ports grow the stack downwards
+    return static_cast<unsigned char*>(tx_thread_stack_ptr) - static_cast<unsigned char*>(tx_thread_stack_start);
+}
+
 thread::state thread::get_state() const
 {
     state s;
@@ -167,10 +250,93 @@ thread::thread(void *pstack ,std::uint32_t stack_size,
             prio,                       // UINT priority
             prio,                       // UINT preempt_threshold
             TX_NO_TIME_SLICE,           // ULONG time_slice
-            TX_AUTO_START);             // UINT auto_start
+            TX_DONT_START);             // UINT auto_start
     assert(result == TX_SUCCESS);
+
+#ifndef TX_DISABLE_NOTIFY_CALLBACKS
+    // the exit is observed from the start, so join and detach can't miss it
+    set_entry_exit_callback(&thread::exit_callback, nullptr);
+#endif // !TX_DISABLE_NOTIFY_CALLBACKS
+
+    // an active thread group starts the thread later, together with its siblings
+    if (!thread_group::defer(*this))
+    {
+        result = tx_thread_resume(this);
+        assert(result == TX_SUCCESS);
+    }
+}
+
+thread_handle::thread_handle(thread_handle&& other)
+    : thread_(other.thread_), owning_(other.owning_)
+{
+    other.thread_ = nullptr;
+    other.owning_ = false;
+}
+
+thread_handle& thread_handle::operator=(thread_handle&& other)
+{
+    if (this != &other)
+    {
+        release();
+        thread_ = other.thread_;
+        owning_ = other.owning_;
+        other.thread_ = nullptr;
+        other.owning_ = false;
+    }
+    return *this;
+}
+
+thread_handle::~thread_handle()
+{
+    release();
+}
+
+void thread_handle::release()
+{
+#ifndef TX_DISABLE_NOTIFY_CALLBACKS
+    if (owning_ && (thread_ != nullptr))
+    {
+        thread_->join();
+    }
+#endif // !TX_DISABLE_NOTIFY_CALLBACKS
+    thread_ = nullptr;
+    owning_ = false;
 }
 
+thread::id thread_handle::get_id() const
+{
+    return (thread_ != nullptr) ? thread_->get_id() : 0;
+}
+
+void thread_handle::detach()
+{
+#ifndef TX_DISABLE_NOTIFY_CALLBACKS
+    if (owning_ && (thread_ != nullptr))
+    {
+        thread_->detach();
+    }
+#endif // !TX_DISABLE_NOTIFY_CALLBACKS
+    thread_ = nullptr;
+    owning_ = false;
+}
+
+#ifndef TX_DISABLE_NOTIFY_CALLBACKS
+
+    bool thread_handle::joinable() const
+    {
+        return (thread_ != nullptr) && thread_->joinable();
+    }
+
+    void thread_handle::join()
+    {
+        assert(thread_ != nullptr);
+        thread_->join();
+        thread_ = nullptr;
+        owning_ = false;
+    }
+
+#endif // !TX_DISABLE_NOTIFY_CALLBACKS
+
 void this_thread::yield()
 {
     tx_thread_relinquish();
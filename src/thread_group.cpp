@@ -0,0 +1,149 @@
+/**
+ * @file      thread_group.cpp
+ * @brief     Deferred start of a group of threads
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "threadx/thread_group.h"
+#include "threadx/cpu.h"
+#include "tx_services.h"
+
+using namespace threadx;
+using namespace threadx::native;
+
+namespace
+{
+    // the innermost active group, groups of different contexts may be nested
+    thread_group *active_group = nullptr;
+}
+
+thread_group::thread_group(thread **storage, std::size_t capacity)
+    : storage_(storage), capacity_(capacity), count_(0), owner_(thread::get_current()),
+      previous_(nullptr), active_(true)
+{
+    cpu::critical_section cs;
+    lock_guard<cpu::critical_section> lock(cs);
+    previous_ = active_group;
+    active_group = this;
+}
+
+thread_group::~thread_group()
+{
+    start_all();
+}
+
+void thread_group::deactivate()
+{
+    cpu::critical_section cs;
+    lock_guard<cpu::critical_section> lock(cs);
+    for (thread_group **pg = &active_group; *pg != nullptr; pg = &(*pg)->previous_)
+    {
+        if (*pg == this)
+        {
+            *pg = previous_;
+            break;
+        }
+    }
+    active_ = false;
+}
+
+bool thread_group::defer(thread& t)
+{
+    const thread *creator = thread::get_current();
+
+    cpu::critical_section cs;
+    lock_guard<cpu::critical_section> lock(cs);
+    for (thread_group *g = active_group; g != nullptr; g = g->previous_)
+    {
+        if (g->owner_ != creator)
+        {
+            continue;
+        }
+        // a full group lets the thread start right away
+        if (g->count_ == g->capacity_)
+        {
+            return false;
+        }
+        g->storage_[g->count_++] = &t;
+        return true;
+    }
+    return false;
+}
+
+void thread_group::forget(thread& t)
+{
+    cpu::critical_section cs;
+    lock_guard<cpu::critical_section> lock(cs);
+    for (thread_group *g = active_group; g != nullptr; g = g->previous_)
+    {
+        for (std::size_t i = 0; i < g->count_; i++)
+        {
+            if (g->storage_[i] == &t)
+            {
+                g->count_--;
+                for (; i < g->count_; i++)
+                {
+                    g->storage_[i] = g->storage_[i + 1];
+                }
+                return;
+            }
+        }
+    }
+}
+
+void thread_group::start_all()
+{
+    if (active_)
+    {
+        deactivate();
+    }
+    if (count_ == 0)
+    {
+        return;
+    }
+
+#ifndef TX_DISABLE_PREEMPTION_THRESHOLD
+    // no thread may preempt the caller until all of them are ready,
+    // the scheduler then picks the most urgent one in a single pass
+    TX_THREAD *caller = tx_thread_identify();
+    UINT old_threshold = 0;
+    if ((caller != nullptr) && !this_cpu::is_in_isr())
+    {
+        UINT result = tx_thread_preemption_change(caller, 0, &old_threshold);
+        assert(result == TX_SUCCESS);
+    }
+#endif
+
+    for (std::size_t i = 0; i < count_; i++)
+    {
+        storage_[i]->resume();
+    }
+    count_ = 0;
+
+#ifndef TX_DISABLE_PREEMPTION_THRESHOLD
+    if ((caller != nullptr) && !this_cpu::is_in_isr())
+    {
+        UINT result = tx_thread_preemption_change(caller, old_threshold, &old_threshold);
+        assert(result == TX_SUCCESS);
+    }
+#endif
+}
@@ -0,0 +1,162 @@
+/**
+ * @file      thread_pool.cpp
+ * @brief     ThreadX pool of runtime created threads
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <cstddef>
+#include <new>
+#include "threadx/thread_pool.h"
+#include "threadx/cpu.h"
+
+using namespace threadx;
+using namespace threadx::native;
+
+namespace
+{
+    // all constructed pools, for finding the pool of a finished thread
+    thread_pool *pools = nullptr;
+}
+
+/// @brief  Gives the pool access to the protected thread constructor.
+class thread_pool::pooled_thread : public thread
+{
+public:
+    pooled_thread(void *pstack, std::uint32_t stack_size,
+            function func, void *param, priority prio, const char *name)
+        : thread(pstack, stack_size, func, reinterpret_cast<ULONG>(param), prio, name)
+    {
+    }
+};
+
+thread_handle thread_pool::create(thread::function func, void *param,
+        thread::priority prio, const char *name)
+{
+    static_assert(sizeof(pooled_thread) == sizeof(thread), "the slots only fit plain threads");
+
+    slot *s;
+    {
+        cpu::critical_section cs;
+        lock_guard<cpu::critical_section> lock(cs);
+
+        s = free_;
+        if (s == nullptr)
+        {
+            return thread_handle();
+        }
+        free_ = s->next;
+        available_--;
+        s->in_use = true;
+    }
+
+    // the previous thread of the slot is only deleted when the slot is reused,
+    // as the thread can't delete itself from its exit callback
+    if (s->constructed)
+    {
+        reinterpret_cast<thread*>(&s->storage)->~thread();
+    }
+
+    auto *t = new (&s->storage) pooled_thread(stacks_ + ((s - slots_) * stack_size_), stack_size_,
+            func, param, prio, name);
+    s->constructed = true;
+    return thread_handle(*t, true);
+}
+
+std::size_t thread_pool::available() const
+{
+    return available_;
+}
+
+thread_pool::slot *thread_pool::find(thread *t) const
+{
+    auto *s = reinterpret_cast<slot*>(reinterpret_cast<unsigned char*>(t) - offsetof(slot, storage));
+    return ((s >= slots_) && (s < (slots_ + count_))) ? s : nullptr;
+}
+
+void thread_pool::release(slot *s)
+{
+    if (s->in_use)
+    {
+        s->in_use = false;
+        s->next = free_;
+        free_ = s;
+        available_++;
+    }
+}
+
+void thread_pool::reclaim(thread *t)
+{
+    cpu::critical_section cs;
+    lock_guard<cpu::critical_section> lock(cs);
+
+    for (auto *pool = pools; pool != nullptr; pool = pool->next_pool_)
+    {
+        auto *s = pool->find(t);
+        if (s != nullptr)
+        {
+            pool->release(s);
+            break;
+        }
+    }
+}
+
+thread_pool::thread_pool(slot *slots, unsigned char *stacks, std::size_t count, std::size_t stack_size)
+    : slots_(slots), stacks_(stacks), count_(count), stack_size_(stack_size),
+      free_(nullptr), available_(count), next_pool_(nullptr)
+{
+    for (std::size_t i = count; i > 0; i--)
+    {
+        slots_[i - 1].constructed = false;
+        slots_[i - 1].in_use = false;
+        slots_[i - 1].next = free_;
+        free_ = &slots_[i - 1];
+    }
+
+    cpu::critical_section cs;
+    lock_guard<cpu::critical_section> lock(cs);
+    next_pool_ = pools;
+    pools = this;
+}
+
+thread_pool::~thread_pool()
+{
+    {
+        cpu::critical_section cs;
+        lock_guard<cpu::critical_section> lock(cs);
+        for (auto **pool = &pools; *pool != nullptr; pool = &(*pool)->next_pool_)
+        {
+            if (*pool == this)
+            {
+                *pool = next_pool_;
+                break;
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < count_; i++)
+    {
+        if (slots_[i].constructed)
+        {
+            reinterpret_cast<thread*>(&slots_[i].storage)->~thread();
+        }
+    }
+}
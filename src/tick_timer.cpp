@@ -24,6 +24,7 @@
  * SOFTWARE.
  */
 #include "threadx/tick_timer.h"
+#include "tx_services.h"
 
 using namespace threadx;
 using namespace threadx::native;
@@ -0,0 +1,86 @@
+/**
+ * @file      tx_services.h
+ * @brief     ThreadX service call selection for the wrapper classes
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __THREADX_TX_SERVICES_H_
+#define __THREADX_TX_SERVICES_H_
+
+// The wrapper classes guarantee valid object pointers and states by construction,
+// so their service calls may bypass the argument validation layer (_txe_*)
+// of ThreadX, while the rest of the application keeps using it.
+#if defined(THREADX_MCPP_DISABLE_ERROR_CHECKING) && !defined(TX_DISABLE_ERROR_CHECKING)
+
+#undef  tx_mutex_create
+#define tx_mutex_create                 _tx_mutex_create
+#undef  tx_mutex_delete
+#define tx_mutex_delete                 _tx_mutex_delete
+#undef  tx_mutex_get
+#define tx_mutex_get                    _tx_mutex_get
+#undef  tx_mutex_put
+#define tx_mutex_put                    _tx_mutex_put
+
+#undef  tx_semaphore_create
+#define tx_semaphore_create             _tx_semaphore_create
+#undef  tx_semaphore_delete
+#define tx_semaphore_delete             _tx_semaphore_delete
+#undef  tx_semaphore_get
+#define tx_semaphore_get                _tx_semaphore_get
+#undef  tx_semaphore_put
+#define tx_semaphore_put                _tx_semaphore_put
+
+#undef  tx_thread_create
+#define tx_thread_create                _tx_thread_create
+#undef  tx_thread_delete
+#define tx_thread_delete                _tx_thread_delete
+#undef  tx_thread_entry_exit_notify
+#define tx_thread_entry_exit_notify     _tx_thread_entry_exit_notify
+#undef  tx_thread_preemption_change
+#define tx_thread_preemption_change     _tx_thread_preemption_change
+#undef  tx_thread_priority_change
+#define tx_thread_priority_change       _tx_thread_priority_change
+#undef  tx_thread_relinquish
+#define tx_thread_relinquish            _tx_thread_relinquish
+#undef  tx_thread_resume
+#define tx_thread_resume                _tx_thread_resume
+#undef  tx_thread_sleep
+#define tx_thread_sleep                 _tx_thread_sleep
+#undef  tx_thread_suspend
+#define tx_thread_suspend               _tx_thread_suspend
+#undef  tx_thread_terminate
+#define tx_thread_terminate             _tx_thread_terminate
+#undef  tx_thread_wait_abort
+#define tx_thread_wait_abort            _tx_thread_wait_abort
+
+#undef  tx_timer_activate
+#define tx_timer_activate               _tx_timer_activate
+#undef  tx_timer_change
+#define tx_timer_change                 _tx_timer_change
+#undef  tx_timer_create
+#define tx_timer_create                 _tx_timer_create
+#undef  tx_timer_delete
+#define tx_timer_delete                 _tx_timer_delete
+
+#endif // THREADX_MCPP_DISABLE_ERROR_CHECKING && !TX_DISABLE_ERROR_CHECKING
+
+#endif // __THREADX_TX_SERVICES_H_
@@ -0,0 +1,221 @@
+/**
+ * @file      wait_queue.cpp
+ * @brief     ThreadX wait queue for custom synchronizers
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "threadx/wait_queue.h"
+#include "tx_services.h"
+
+namespace threadx
+{
+    namespace native
+    {
+        #include "tx_thread.h"
+
+        // the suspension type reported for the threads in a wait queue
+        constexpr UINT WAIT_QUEUE_SUSP = TX_IO_DRIVER;
+    }
+}
+using namespace threadx;
+using namespace threadx::native;
+
+namespace
+{
+    // the kernel's preemption counter is only modified under TX_DISABLE,
+    // which is the inter-core protection on SMP ports, the same as the synchronizer's critical section
+    inline void preempt_disable(const wait_queue::lock_type& lock)
+    {
+        assert(lock.owns_lock());
+        (void)lock;
+        _tx_thread_preempt_disable++;
+    }
+
+    inline void preempt_enable(const wait_queue::lock_type& lock)
+    {
+        assert(lock.owns_lock() && (_tx_thread_preempt_disable > 0));
+        (void)lock;
+        _tx_thread_preempt_disable--;
+    }
+}
+
+void wait_queue::enqueue(TX_THREAD *t)
+{
+    if (head_ == nullptr)
+    {
+        t->tx_thread_suspended_next = t;
+        t->tx_thread_suspended_previous = t;
+        head_ = t;
+    }
+    else
+    {
+        // the list is circular, insert before the first thread with lower priority, or at the end
+        TX_THREAD *next = head_;
+        if (order_ == order::priority)
+        {
+            std::size_t i = 0;
+            while ((i < count_) && (next->tx_thread_priority <= t->tx_thread_priority))
+            {
+                next = next->tx_thread_suspended_next;
+                i++;
+            }
+            if (i == 0)
+            {
+                head_ = t;
+            }
+        }
+        TX_THREAD *previous = next->tx_thread_suspended_previous;
+        t->tx_thread_suspended_next = next;
+        t->tx_thread_suspended_previous = previous;
+        previous->tx_thread_suspended_next = t;
+        next->tx_thread_suspended_previous = t;
+    }
+    count_++;
+}
+
+void wait_queue::remove(TX_THREAD *t)
+{
+    count_--;
+    if (count_ == 0)
+    {
+        head_ = nullptr;
+    }
+    else
+    {
+        t->tx_thread_suspended_previous->tx_thread_suspended_next = t->tx_thread_suspended_next;
+        t->tx_thread_suspended_next->tx_thread_suspended_previous = t->tx_thread_suspended_previous;
+        if (head_ == t)
+        {
+            head_ = t->tx_thread_suspended_next;
+        }
+    }
+    t->tx_thread_suspended_next = nullptr;
+    t->tx_thread_suspended_previous = nullptr;
+}
+
+void wait_queue::cleanup(TX_THREAD *t, ULONG suspension_sequence)
+{
+    // called on timeout or wait abort, following the pattern of the ThreadX objects
+#ifndef TX_NOT_INTERRUPTABLE
+    TX_INTERRUPT_SAVE_AREA
+    TX_DISABLE
+
+    if ((t->tx_thread_suspend_cleanup == &wait_queue::cleanup) &&
+        (t->tx_thread_suspension_sequence == suspension_sequence))
+#else
+    (void)suspension_sequence;
+#endif
+    {
+        auto *queue = static_cast<wait_queue*>(t->tx_thread_suspend_control_block);
+
+        t->tx_thread_suspend_cleanup = nullptr;
+        queue->remove(t);
+
+        if (t->tx_thread_state == WAIT_QUEUE_SUSP)
+        {
+            t->tx_thread_suspend_status = TX_NO_INSTANCE;
+#ifdef TX_NOT_INTERRUPTABLE
+            _tx_thread_system_ni_resume(t);
+#else
+            _tx_thread_preempt_disable++;
+            TX_RESTORE
+            _tx_thread_system_resume(t);
+            TX_DISABLE
+#endif
+        }
+    }
+#ifndef TX_NOT_INTERRUPTABLE
+    TX_RESTORE
+#endif
+}
+
+bool wait_queue::suspend(lock_type& lock, tick_timer::duration timeout)
+{
+    assert(lock.owns_lock() && !this_cpu::is_in_isr());
+
+    if (to_ticks(timeout) == TX_NO_WAIT)
+    {
+        return false;
+    }
+
+    TX_THREAD *t;
+    TX_THREAD_GET_CURRENT(t)
+
+    t->tx_thread_suspend_cleanup = &wait_queue::cleanup;
+    t->tx_thread_suspend_control_block = this;
+#ifndef TX_NOT_INTERRUPTABLE
+    t->tx_thread_suspension_sequence++;
+#endif
+    enqueue(t);
+    t->tx_thread_state = WAIT_QUEUE_SUSP;
+
+#ifdef TX_NOT_INTERRUPTABLE
+    _tx_thread_system_ni_suspend(t, to_ticks(timeout));
+    lock.unlock();
+#else
+    t->tx_thread_suspending = TX_TRUE;
+    t->tx_thread_timer.tx_timer_internal_remaining_ticks = to_ticks(timeout);
+    preempt_disable(lock);
+
+    // the suspension is prepared, the lock can be released before switching out
+    lock.unlock();
+    _tx_thread_system_suspend(t);
+#endif
+
+    lock.lock();
+    return t->tx_thread_suspend_status == TX_SUCCESS;
+}
+
+std::size_t wait_queue::notify(lock_type& lock, std::size_t n)
+{
+    assert(lock.owns_lock());
+
+    // hold off preemption until all woken threads are resumed,
+    // and the caller's critical section is released
+    preempt_disable(lock);
+
+    std::size_t woken = 0;
+    while ((woken < n) && (head_ != nullptr))
+    {
+        TX_THREAD *t = head_;
+        remove(t);
+        t->tx_thread_suspend_cleanup = nullptr;
+        t->tx_thread_suspend_status = TX_SUCCESS;
+#ifdef TX_NOT_INTERRUPTABLE
+        _tx_thread_system_ni_resume(t);
+#else
+        // consumed by the resume
+        preempt_disable(lock);
+        _tx_thread_system_resume(t);
+#endif
+        woken++;
+    }
+
+    preempt_enable(lock);
+    lock.unlock();
+
+    if (woken > 0)
+    {
+        _tx_thread_system_preempt_check();
+    }
+    return woken;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file      watchdog.cpp
+ * @brief     ThreadX software watchdog supervisor
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "threadx/watchdog.h"
+#include "tx_services.h"
+
+using namespace threadx;
+using namespace threadx::native;
+
+watchdog::entry::entry(watchdog& wd, thread& t, tick_timer::duration deadline)
+    : watchdog_(wd), thread_(t), next_(nullptr), deadline_(to_ticks(deadline)),
+      last_kick_(to_ticks(tick_timer::now())), reported_kick_(0), reported_(false)
+{
+    watchdog_.add(*this);
+}
+
+watchdog::entry::~entry()
+{
+    watchdog_.remove(*this);
+}
+
+void watchdog::add(entry& e)
+{
+    lock_guard<mutex> lock(mutex_);
+    e.next_ = entries_;
+    entries_ = &e;
+}
+
+void watchdog::remove(entry& e)
+{
+    lock_guard<mutex> lock(mutex_);
+    for (entry** pe = &entries_; *pe != nullptr; pe = &(*pe)->next_)
+    {
+        if (*pe == &e)
+        {
+            *pe = e.next_;
+            break;
+        }
+    }
+}
+
+std::size_t watchdog::check()
+{
+    std::size_t stalled = 0;
+    lock_guard<mutex> lock(mutex_);
+    const auto now = to_ticks(tick_timer::now());
+
+    for (entry* e = entries_; e != nullptr; e = e->next_)
+    {
+        const auto last_kick = e->last_kick_.load(std::memory_order_relaxed);
+        const auto since_kick = now - last_kick;
+        if (since_kick <= e->deadline_)
+        {
+            continue;
+        }
+        stalled++;
+
+        if (e->reported_ && (e->reported_kick_ == last_kick))
+        {
+            continue;
+        }
+        e->reported_ = true;
+        e->reported_kick_ = last_kick;
+
+        const report r { e->thread_, e->thread_.get_name(), e->thread_.get_state(),
+                e->thread_.get_stack_space(), tick_timer::duration(since_kick) };
+        on_stall_(r);
+    }
+    return stalled;
+}
+
+void watchdog::supervise()
+{
+    auto wake_time = tick_timer::now();
+    while (true)
+    {
+        wake_time += period_;
+        const auto remaining = wake_time - tick_timer::now();
+        if (remaining <= period_)
+        {
+            this_thread::sleep_for(remaining);
+        }
+        else
+        {
+            // the checks overran the period, resynchronize
+            wake_time = tick_timer::now();
+        }
+        (void)check();
+    }
+}
+
+watchdog::watchdog(handler on_stall, tick_timer::duration period)
+    : entries_(nullptr), on_stall_(on_stall), period_(period)
+{
+    assert(on_stall != nullptr);
+}
@@ -0,0 +1,166 @@
+/**
+ * @file      benchmark.cpp
+ * @brief     Wrapper benchmark on the host backend and the ThreadX Linux port
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "threadx/cpu.h"
+#include "threadx/footprint.h"
+#include "threadx/mutex.h"
+#include "threadx/scheduler.h"
+#include "threadx/semaphore.h"
+#include "threadx/thread.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// The same benchmark is built on the host backend and on the ThreadX Linux port,
+// so it starts the kernel, and runs from a thread created in tx_application_define.
+
+using namespace threadx;
+
+namespace
+{
+    using clock = std::chrono::steady_clock;
+
+    std::size_t scale = 100;
+
+    void report(const char *name, clock::time_point start, std::size_t count)
+    {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start);
+        std::printf("%-32s %12.1f ns/op\n", name, static_cast<double>(elapsed.count()) / count);
+    }
+
+    template<class... Ts>
+    void report_footprint(const char *name)
+    {
+        std::printf("%-32s %12zu bytes, %zu of stacks\n", name, footprint<Ts...>::value, footprint<Ts...>::stack);
+    }
+
+    // the RAM used by the benchmark's kernel objects
+    void object_footprint()
+    {
+        report_footprint<mutex>("mutex");
+        report_footprint<binary_semaphore>("binary_semaphore");
+        report_footprint<static_thread<4096>>("static_thread<4096>");
+        report_footprint<static_thread<16384>, static_thread<4096>, mutex, binary_semaphore[2]>("benchmark objects");
+    }
+
+    void critical_section_lock()
+    {
+        const std::size_t count = 10000 * scale;
+        cpu::critical_section cs;
+        auto start = clock::now();
+        for (std::size_t i = 0; i < count; i++)
+        {
+            lock_guard<cpu::critical_section> lock(cs);
+        }
+        report("critical_section lock/unlock", start, count);
+    }
+
+    void mutex_lock()
+    {
+        const std::size_t count = 10000 * scale;
+        mutex m;
+        auto start = clock::now();
+        for (std::size_t i = 0; i < count; i++)
+        {
+            lock_guard<mutex> lock(m);
+        }
+        report("mutex lock/unlock", start, count);
+    }
+
+    struct ping_pong
+    {
+        binary_semaphore ping;
+        binary_semaphore pong;
+        std::size_t count;
+    };
+
+    void pong_main(ping_pong *pp)
+    {
+        for (std::size_t i = 0; i < pp->count; i++)
+        {
+            pp->ping.acquire();
+            pp->pong.release();
+        }
+    }
+
+    void semaphore_ping_pong()
+    {
+        ping_pong pp;
+        pp.count = 1000 * scale;
+        static_thread<4096> partner(pong_main, &pp);
+        auto start = clock::now();
+        for (std::size_t i = 0; i < pp.count; i++)
+        {
+            pp.ping.release();
+            pp.pong.acquire();
+        }
+        report("semaphore ping-pong round trip", start, pp.count);
+        partner.join();
+    }
+
+    void nothing(int *)
+    {
+    }
+
+    void thread_create_join()
+    {
+        const std::size_t count = 10 * scale;
+        auto start = clock::now();
+        for (std::size_t i = 0; i < count; i++)
+        {
+            static_thread<4096> t(nothing, static_cast<int*>(nullptr));
+            t.join();
+        }
+        report("thread create/join/delete", start, count);
+    }
+
+    void benchmark_main(int *)
+    {
+        critical_section_lock();
+        mutex_lock();
+        semaphore_ping_pong();
+        thread_create_join();
+        object_footprint();
+
+        // the benchmark thread can't destroy itself with the static objects
+        std::fflush(stdout);
+        std::_Exit(0);
+    }
+}
+
+extern "C" void tx_application_define(void *first_unused_memory)
+{
+    (void)first_unused_memory;
+    static static_thread<16384> benchmark(benchmark_main, static_cast<int*>(nullptr));
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+    {
+        scale = std::strtoul(argv[1], nullptr, 10);
+    }
+    scheduler::start();
+}
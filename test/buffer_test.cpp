@@ -0,0 +1,131 @@
+/**
+ * @file      buffer_test.cpp
+ * @brief     Tests of the triple and ping-pong buffers
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test.h"
+#include "threadx/ping_pong_buffer.h"
+#include "threadx/thread.h"
+#include "threadx/triple_buffer.h"
+
+using namespace threadx;
+
+namespace
+{
+    constexpr int COUNT = 1000;
+
+    struct frame
+    {
+        int first;
+        int second;
+    };
+
+    void publish_frames(triple_buffer<frame> *tb)
+    {
+        for (int i = 1; i <= COUNT; i++)
+        {
+            frame& f = tb->write_buffer();
+            f.first = i;
+            this_thread::yield();
+            f.second = i;
+            tb->publish();
+        }
+    }
+
+    void test_triple_buffer_latest_value()
+    {
+        triple_buffer<frame> tb(frame { 0, 0 });
+        TEST_CHECK(!tb.update());
+        static_thread<4096> producer(publish_frames, &tb);
+
+        // the values are skipped but never torn or reordered
+        int last = 0;
+        while (last < COUNT)
+        {
+            if (!tb.update_for(std::chrono::seconds(1)))
+            {
+                break;
+            }
+            const frame& f = tb.read_buffer();
+            TEST_CHECK(f.first == f.second);
+            TEST_CHECK(f.first > last);
+            last = f.first;
+        }
+        TEST_CHECK(last == COUNT);
+        producer.join();
+        TEST_CHECK(!tb.update());
+    }
+
+    void write_sequence(ping_pong_buffer<int> *pp)
+    {
+        for (int i = 0; i < COUNT; i++)
+        {
+            pp->begin_write() = i;
+            pp->end_write();
+        }
+    }
+
+    void test_ping_pong_buffer_keeps_all()
+    {
+        ping_pong_buffer<int> pp;
+        TEST_CHECK(pp.try_begin_read_for(std::chrono::milliseconds(5)) == nullptr);
+        static_thread<4096> producer(write_sequence, &pp);
+
+        // every value arrives in order
+        int expected = 0;
+        for (; expected < COUNT; expected++)
+        {
+            int *value = pp.try_begin_read_for(std::chrono::seconds(1));
+            if (value == nullptr)
+            {
+                break;
+            }
+            TEST_CHECK(*value == expected);
+            pp.end_read();
+        }
+        TEST_CHECK(expected == COUNT);
+        producer.join();
+    }
+
+    void test_ping_pong_producer_blocks_ahead()
+    {
+        // both buffers are filled, the producer waits for the consumer
+        ping_pong_buffer<int> pp;
+        pp.begin_write() = 1;
+        pp.end_write();
+        pp.begin_write() = 2;
+        pp.end_write();
+        TEST_CHECK(pp.try_begin_write_for(std::chrono::milliseconds(5)) == nullptr);
+        TEST_CHECK(pp.begin_read() == 1);
+        pp.end_read();
+        TEST_CHECK(pp.try_begin_write_for(std::chrono::milliseconds(5)) != nullptr);
+    }
+}
+
+int main()
+{
+    test_triple_buffer_latest_value();
+    test_ping_pong_buffer_keeps_all();
+    test_ping_pong_producer_blocks_ahead();
+    return test::result();
+}
@@ -0,0 +1,105 @@
+/**
+ * @file      ceiling_mutex_test.cpp
+ * @brief     Tests of the priority ceiling mutex on SMP
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test.h"
+#include "threadx/ceiling_mutex.h"
+#include "threadx/semaphore.h"
+#include "threadx/thread.h"
+
+using namespace threadx;
+
+namespace
+{
+    using test_mutex = ceiling_mutex<5>;
+    constexpr thread::priority USER_PRIORITY = 10;
+
+    native::UINT own_threshold()
+    {
+        return native::tx_thread_identify()->tx_thread_user_preempt_threshold;
+    }
+
+    struct context
+    {
+        test_mutex mutex;
+        binary_semaphore locked { 0 };
+        binary_semaphore tried { 0 };
+        bool owner_raised = false;
+        bool owner_restored = false;
+    };
+
+    // the host doesn't schedule by the threshold, so the owner may wait while holding the lock
+    void owner(context *ctx)
+    {
+        ctx->mutex.lock();
+        ctx->owner_raised = own_threshold() == test_mutex::ceiling();
+        ctx->locked.release();
+        ctx->tried.acquire();
+        ctx->mutex.unlock();
+        ctx->owner_restored = own_threshold() == USER_PRIORITY;
+    }
+
+    void contender(context *ctx)
+    {
+        ctx->locked.acquire();
+
+        // owned by the thread on the other core, the threshold is rolled back
+        TEST_CHECK(!ctx->mutex.try_lock());
+        TEST_CHECK(own_threshold() == USER_PRIORITY);
+        ctx->tried.release();
+    }
+
+    void test_try_lock_contended()
+    {
+        context ctx;
+        static_thread<4096> c(contender, &ctx, USER_PRIORITY);
+        static_thread<4096> o(owner, &ctx, USER_PRIORITY);
+        o.join();
+        c.join();
+        TEST_CHECK(ctx.owner_raised);
+        TEST_CHECK(ctx.owner_restored);
+    }
+
+    void try_uncontended(test_mutex *mutex)
+    {
+        TEST_CHECK(mutex->try_lock());
+        TEST_CHECK(own_threshold() == test_mutex::ceiling());
+        mutex->unlock();
+        TEST_CHECK(own_threshold() == USER_PRIORITY);
+    }
+
+    void test_try_lock_uncontended()
+    {
+        test_mutex mutex;
+        static_thread<4096> t(try_uncontended, &mutex, USER_PRIORITY);
+        t.join();
+    }
+}
+
+int main()
+{
+    test_try_lock_uncontended();
+    test_try_lock_contended();
+    return test::result();
+}
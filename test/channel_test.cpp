@@ -0,0 +1,223 @@
+/**
+ * @file      channel_test.cpp
+ * @brief     Tests of the channel
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test.h"
+#include "threadx/channel.h"
+#include "threadx/thread.h"
+#include <atomic>
+
+using namespace threadx;
+
+namespace
+{
+    template<std::size_t N>
+    struct producer_context
+    {
+        channel<int, N> ch;
+        int count;
+    };
+
+    template<std::size_t N>
+    void produce(producer_context<N> *ctx)
+    {
+        for (int i = 0; i < ctx->count; i++)
+        {
+            ctx->ch.send(i);
+        }
+        ctx->ch.close();
+    }
+
+    template<std::size_t N>
+    void test_receive_until_closed()
+    {
+        producer_context<N> ctx;
+        ctx.count = 100;
+        static_thread<4096> producer(produce<N>, &ctx);
+
+        int expected = 0;
+        for (int value : ctx.ch)
+        {
+            TEST_CHECK(value == expected);
+            expected++;
+        }
+        TEST_CHECK(expected == ctx.count);
+        TEST_CHECK(ctx.ch.is_closed());
+        producer.join();
+    }
+
+    void test_closed_buffer_drains()
+    {
+        channel<int, 4> ch;
+        TEST_CHECK(ch.send(1));
+        TEST_CHECK(ch.send(2));
+        ch.close();
+
+        // sends fail, the stored values are still received
+        TEST_CHECK(!ch.send(3));
+        int value = 0;
+        TEST_CHECK(ch.receive(value) && (value == 1));
+        TEST_CHECK(ch.receive(value) && (value == 2));
+        TEST_CHECK(!ch.receive(value));
+    }
+
+    void wait_receive(channel<int, 2> *ch)
+    {
+        int value;
+        (void)ch->receive(value);
+    }
+
+    void test_close_releases_receivers()
+    {
+        channel<int, 2> ch;
+        static_thread<4096> a(wait_receive, &ch), b(wait_receive, &ch);
+        this_thread::sleep_for(std::chrono::milliseconds(10));
+        ch.close();
+        a.join();
+        b.join();
+        TEST_CHECK(ch.is_closed());
+    }
+
+    constexpr int SENDERS = 3;
+    constexpr int SENDS = 200;
+
+    std::atomic<int> taken[SENDERS];
+
+    // the receiver takes the value by moving it, before the sender may be released
+    struct tagged
+    {
+        int sender;
+        int seq;
+
+        tagged& operator=(tagged&& other)
+        {
+            sender = other.sender;
+            seq = other.seq;
+            taken[sender]++;
+            return *this;
+        }
+        tagged(int s = 0, int q = 0)
+            : sender(s), seq(q)
+        {
+        }
+        tagged(tagged&& other) = default;
+    };
+
+    struct sender_context
+    {
+        channel<tagged, 0> *ch;
+        int sender;
+        bool ok;
+    };
+
+    void send_tagged(sender_context *ctx)
+    {
+        ctx->ok = true;
+        for (int i = 0; i < SENDS; i++)
+        {
+            ctx->ok = ctx->ch->send(tagged(ctx->sender, i)) && ctx->ok;
+
+            // the send returns only once its own value is taken
+            ctx->ok = (taken[ctx->sender] > i) && ctx->ok;
+        }
+    }
+
+    void test_rendezvous_multiple_senders()
+    {
+        channel<tagged, 0> ch;
+        sender_context ctx[SENDERS];
+        for (int s = 0; s < SENDERS; s++)
+        {
+            taken[s] = 0;
+            ctx[s] = sender_context { &ch, s, false };
+        }
+        static_thread<4096> a(send_tagged, &ctx[0]), b(send_tagged, &ctx[1]), c(send_tagged, &ctx[2]);
+
+        int next[SENDERS] = {};
+        bool ordered = true;
+        for (int i = 0; i < (SENDERS * SENDS); i++)
+        {
+            tagged value;
+            TEST_CHECK(ch.receive(value));
+            ordered = ordered && (value.seq == next[value.sender]);
+            next[value.sender]++;
+        }
+        a.join();
+        b.join();
+        c.join();
+        TEST_CHECK(ordered);
+        for (auto& x : ctx)
+        {
+            TEST_CHECK(x.ok);
+        }
+    }
+
+    struct blocked_sender
+    {
+        channel<int, 0> *ch;
+        bool sent;
+    };
+
+    void send_one(blocked_sender *ctx)
+    {
+        ctx->sent = ctx->ch->send(1);
+    }
+
+    void test_close_fails_pending_sends()
+    {
+        // one sender waits for a receiver, the other for the handoff slot
+        channel<int, 0> ch;
+        blocked_sender first { &ch, true }, second { &ch, true };
+        static_thread<4096> a(send_one, &first), b(send_one, &second);
+        this_thread::sleep_for(std::chrono::milliseconds(10));
+        ch.close();
+        a.join();
+        b.join();
+        TEST_CHECK(!first.sent && !second.sent);
+
+        // the withdrawn value isn't received
+        int value;
+        TEST_CHECK(!ch.receive(value));
+    }
+
+    void test_receive_timeout()
+    {
+        channel<int, 1> ch;
+        int value;
+        TEST_CHECK(!ch.try_receive_for(value, std::chrono::milliseconds(10)));
+        TEST_CHECK(!ch.is_closed());
+    }
+}
+
+int main()
+{
+    test_receive_until_closed<0>();
+    test_receive_until_closed<3>();
+    test_closed_buffer_drains();
+    test_close_releases_receivers();
+    test_rendezvous_multiple_senders();
+    test_close_fails_pending_sends();
+    test_receive_timeout();
+    return test::result();
+}
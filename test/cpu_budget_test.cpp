@@ -0,0 +1,166 @@
+/**
+ * @file      cpu_budget_test.cpp
+ * @brief     Tests of the CPU budget throttling
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test.h"
+#include "threadx/cpu_budget.h"
+#include <atomic>
+
+using namespace threadx;
+
+namespace
+{
+    constexpr thread::priority USER_PRIORITY = 10;
+    constexpr thread::priority DEMOTED_PRIORITY = 30;
+
+    template<typename Predicate>
+    bool wait_until(Predicate pred)
+    {
+        for (int i = 0; i < 1000; i++)
+        {
+            if (pred())
+            {
+                return true;
+            }
+            this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+    struct worker_context
+    {
+        std::atomic<int> ticks { 0 };
+        std::atomic<bool> stop { false };
+    };
+
+    // the tick interrupt is simulated by the running thread charging itself
+    void work(worker_context *ctx)
+    {
+        while (!ctx->stop)
+        {
+            cpu_budget::on_tick();
+            ctx->ticks++;
+            this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    void test_suspend_until_replenished()
+    {
+        cpu_budget group(tick_timer::duration(5), std::chrono::milliseconds(200));
+        worker_context ctx;
+        static_thread<4096> t(work, &ctx, USER_PRIORITY);
+        cpu_budget::member m(group, t);
+
+        TEST_CHECK(wait_until([&group]() { return group.is_throttled(); }));
+        this_thread::sleep_for(std::chrono::milliseconds(20));
+        const int throttled_ticks = ctx.ticks;
+        TEST_CHECK(throttled_ticks <= 10);
+        this_thread::sleep_for(std::chrono::milliseconds(20));
+        TEST_CHECK(ctx.ticks == throttled_ticks);
+
+        // the next period resumes the thread
+        TEST_CHECK(wait_until([&ctx, throttled_ticks]() { return ctx.ticks > throttled_ticks; }));
+        ctx.stop = true;
+        t.join();
+    }
+
+    void charge(cpu_budget *)
+    {
+        for (int i = 0; i < 5; i++)
+        {
+            cpu_budget::on_tick();
+        }
+    }
+
+    void idle(cpu_budget *)
+    {
+        this_thread::sleep_for(std::chrono::seconds(5));
+    }
+
+    struct joiner_context
+    {
+        cpu_budget *group;
+        std::atomic<bool> joined { false };
+    };
+
+    void join_group(joiner_context *ctx)
+    {
+        cpu_budget::member m(*ctx->group, *thread::get_current());
+        ctx->joined = true;
+    }
+
+    void test_suspend_self_joining_member()
+    {
+        cpu_budget group(tick_timer::duration(5), std::chrono::milliseconds(200));
+        static_thread<4096> a(charge, &group, USER_PRIORITY);
+        cpu_budget::member ma(group, a);
+        TEST_CHECK(wait_until([&group]() { return group.is_throttled(); }));
+
+        // a thread joining the throttled group by itself is suspended until the next period
+        joiner_context ctx;
+        ctx.group = &group;
+        static_thread<4096> b(join_group, &ctx, USER_PRIORITY);
+        this_thread::sleep_for(std::chrono::milliseconds(20));
+        TEST_CHECK(!ctx.joined);
+        TEST_CHECK(wait_until([&ctx]() { return ctx.joined.load(); }));
+        TEST_CHECK(!group.is_throttled());
+        b.join();
+        a.join();
+    }
+
+    void test_demote_joining_member()
+    {
+        cpu_budget group(tick_timer::duration(5), std::chrono::milliseconds(200),
+                cpu_budget::policy::demote, DEMOTED_PRIORITY);
+        static_thread<4096> a(charge, &group, USER_PRIORITY);
+        static_thread<4096> b(idle, &group, USER_PRIORITY);
+        {
+            cpu_budget::member ma(group, a);
+            TEST_CHECK(wait_until([&group]() { return group.is_throttled(); }));
+            TEST_CHECK(a.get_priority() == DEMOTED_PRIORITY);
+
+            // a thread joining the throttled group is demoted at once
+            {
+                cpu_budget::member mb(group, b);
+                TEST_CHECK(b.get_priority() == DEMOTED_PRIORITY);
+            }
+
+            // leaving the group lifts the throttling
+            TEST_CHECK(b.get_priority() == USER_PRIORITY);
+
+            // the next period restores the priority
+            TEST_CHECK(wait_until([&group]() { return !group.is_throttled(); }));
+            TEST_CHECK(a.get_priority() == USER_PRIORITY);
+        }
+        a.join();
+    }
+}
+
+int main()
+{
+    test_suspend_until_replenished();
+    test_suspend_self_joining_member();
+    test_demote_joining_member();
+    return test::result();
+}
@@ -0,0 +1,130 @@
+/**
+ * @file      critical_section_test.cpp
+ * @brief     Tests of the critical section statistics
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test.h"
+#include "threadx/cpu.h"
+#include <cstring>
+
+using namespace threadx;
+
+namespace
+{
+    using site_statistics = cpu::critical_section::site_statistics;
+
+    void busy(native::ULONG duration)
+    {
+        const native::ULONG start = this_cpu::get_timestamp();
+        while ((this_cpu::get_timestamp() - start) < duration)
+        {
+        }
+    }
+
+    unsigned long_line, short_line, inner_line;
+
+    void long_section()
+    {
+        cpu::critical_section cs; long_line = __LINE__;
+        lock_guard<cpu::critical_section> lock(cs);
+        busy(200000);
+    }
+
+    void short_section()
+    {
+        cpu::critical_section cs; short_line = __LINE__;
+        unique_lock<cpu::critical_section> lock(cs);
+        busy(1000);
+        lock.unlock();
+        lock.lock();
+    }
+
+    void nested_section()
+    {
+        cpu::critical_section outer;
+        lock_guard<cpu::critical_section> lock(outer);
+        cpu::critical_section inner; inner_line = __LINE__;
+        lock_guard<cpu::critical_section> inner_lock(inner);
+    }
+
+    const site_statistics *find(const site_statistics *sites, std::size_t count, unsigned line)
+    {
+        for (std::size_t i = 0; i < count; i++)
+        {
+            if (sites[i].line == line)
+            {
+                return &sites[i];
+            }
+        }
+        return nullptr;
+    }
+
+    void test_sites_through_lock_wrappers()
+    {
+        cpu::critical_section::reset_statistics();
+        for (int i = 0; i < 3; i++)
+        {
+            long_section();
+            short_section();
+        }
+        nested_section();
+
+        site_statistics sites[8];
+        std::size_t count = cpu::critical_section::get_worst_sites(sites, 8);
+
+        // the sites are told apart, even though they share the lock wrappers' code
+        const site_statistics *l = find(sites, count, long_line);
+        const site_statistics *s = find(sites, count, short_line);
+        TEST_CHECK((l != nullptr) && (s != nullptr));
+        if ((l != nullptr) && (s != nullptr))
+        {
+            TEST_CHECK(l == &sites[0]);
+            TEST_CHECK(l->count == 3);
+            TEST_CHECK(l->max >= 200000);
+            TEST_CHECK(l->total >= 3 * 200000);
+            TEST_CHECK(s->count == 6);
+            TEST_CHECK(s->max < l->max);
+        }
+
+        // only the outermost section of a nesting is measured
+        TEST_CHECK(find(sites, count, inner_line) == nullptr);
+        TEST_CHECK(count == 3);
+
+        // the statistics collection itself isn't recorded
+        for (std::size_t i = 0; i < count; i++)
+        {
+            TEST_CHECK(std::strstr(sites[i].file, "critical_section_test.cpp") != nullptr);
+        }
+        count = cpu::critical_section::get_worst_sites(sites, 8);
+        TEST_CHECK(count == 3);
+
+        cpu::critical_section::reset_statistics();
+        TEST_CHECK(cpu::critical_section::get_worst_sites(sites, 8) == 0);
+    }
+}
+
+int main()
+{
+    test_sites_through_lock_wrappers();
+    return test::result();
+}
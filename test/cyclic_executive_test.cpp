@@ -0,0 +1,126 @@
+/**
+ * @file      cyclic_executive_test.cpp
+ * @brief     Tests of the cyclic executive's statistics
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test.h"
+#include "threadx/cyclic_executive.h"
+#include "threadx/thread.h"
+
+using namespace threadx;
+
+namespace
+{
+    // the host's timestamps are in nanoseconds
+    constexpr native::ULONG BUSY_TIME = 200000;
+
+    void busy()
+    {
+        const native::ULONG start = this_cpu::get_timestamp();
+        while ((this_cpu::get_timestamp() - start) < BUSY_TIME)
+        {
+        }
+    }
+
+    void idle()
+    {
+    }
+
+    int long_runs = 0;
+
+    // the third run takes longer than the major frame
+    void occasionally_long()
+    {
+        if (++long_runs == 3)
+        {
+            this_thread::sleep_for(std::chrono::milliseconds(25));
+        }
+    }
+
+    void run(cyclic_executive *exec)
+    {
+        exec->run();
+    }
+
+    void test_major_frame()
+    {
+        cyclic_executive::slot table[] = {
+            { idle, std::chrono::milliseconds(4) },
+            { idle, std::chrono::milliseconds(6), std::chrono::milliseconds(1) },
+            { idle, std::chrono::milliseconds(10) },
+        };
+        cyclic_executive exec(table);
+        TEST_CHECK(exec.get_major_frame() == std::chrono::milliseconds(60));
+    }
+
+    void test_execution_time()
+    {
+        cyclic_executive::slot table[] = {
+            { busy, std::chrono::milliseconds(10) },
+            { idle, std::chrono::milliseconds(20), std::chrono::milliseconds(5) },
+        };
+        cyclic_executive exec(table);
+        {
+            static_thread<4096> t(run, &exec);
+            this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+
+        // the execution times are resolved below the tick
+        const auto& stats = table[0].get_statistics();
+        TEST_CHECK(stats.runs >= 5);
+        TEST_CHECK(stats.min_time >= BUSY_TIME);
+        TEST_CHECK(stats.max_time >= stats.min_time);
+        TEST_CHECK(stats.total_time >= stats.runs * static_cast<std::uint64_t>(BUSY_TIME));
+        TEST_CHECK(table[1].get_statistics().runs >= 2);
+        TEST_CHECK(table[1].get_statistics().max_time < BUSY_TIME);
+        TEST_CHECK(exec.get_frame_overruns() == 0);
+
+        table[0].reset_statistics();
+        TEST_CHECK(table[0].get_statistics().runs == 0);
+    }
+
+    void test_frame_overrun()
+    {
+        cyclic_executive::slot table[] = {
+            { idle, std::chrono::milliseconds(5) },
+            { occasionally_long, std::chrono::milliseconds(10) },
+        };
+        cyclic_executive exec(table);
+        {
+            static_thread<4096> t(run, &exec);
+            this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        TEST_CHECK(long_runs > 3);
+        TEST_CHECK(exec.get_frame_overruns() >= 1);
+        TEST_CHECK(table[1].get_statistics().overruns >= 2);
+        TEST_CHECK(table[1].get_statistics().max_time >= 20000000);
+    }
+}
+
+int main()
+{
+    test_major_frame();
+    test_execution_time();
+    test_frame_overrun();
+    return test::result();
+}
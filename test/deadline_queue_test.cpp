@@ -0,0 +1,117 @@
+/**
+ * @file      deadline_queue_test.cpp
+ * @brief     Tests of the deadline queue cancellation
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test.h"
+#include "threadx/deadline_queue.h"
+#include "threadx/thread.h"
+
+using namespace threadx;
+
+namespace
+{
+    using queue = deadline_queue<int, 4>;
+
+    void test_cancel()
+    {
+        queue q;
+        const auto now = tick_timer::now();
+        auto a = q.push(1, now + std::chrono::milliseconds(30));
+        auto b = q.push(2, now + std::chrono::milliseconds(10));
+        auto c = q.push(3, now + std::chrono::milliseconds(20));
+        TEST_CHECK(a && b && c);
+        TEST_CHECK(q.size() == 3);
+
+        // the earliest leaves, the next one takes its place
+        TEST_CHECK(q.cancel(b));
+        TEST_CHECK(!q.cancel(b));
+        tick_timer::time_point deadline;
+        TEST_CHECK(q.next_deadline(deadline) && (deadline == now + std::chrono::milliseconds(20)));
+        TEST_CHECK(!q.reschedule(b, now));
+
+        // the freed slot is reused, the stale handle doesn't refer to the new value
+        auto d = q.push(4, now);
+        TEST_CHECK(d);
+        TEST_CHECK(!q.cancel(b));
+
+        int value = 0;
+        TEST_CHECK(q.try_pop_due(value) && (value == 4));
+        TEST_CHECK(!q.cancel(d));
+        TEST_CHECK(q.cancel(a) && q.cancel(c));
+        TEST_CHECK(q.empty());
+        TEST_CHECK(!q.try_pop_due(value));
+    }
+
+    void test_cancel_while_waiting()
+    {
+        queue q;
+        const auto now = tick_timer::now();
+        auto early = q.push(1, now + std::chrono::milliseconds(20));
+        (void)q.push(2, now + std::chrono::milliseconds(40));
+
+        int value = 0;
+        TEST_CHECK(q.cancel(early));
+        TEST_CHECK(q.wait_pop_until_due_for(value, std::chrono::seconds(1)));
+        TEST_CHECK(value == 2);
+        TEST_CHECK(tick_timer::now() >= now + std::chrono::milliseconds(40));
+        TEST_CHECK(q.empty());
+    }
+
+    void push_earlier(queue *q)
+    {
+        // each push is the new earliest, waking the waiter repeatedly
+        const int delays[] = { 500, 400, 10 };
+        for (int i = 0; i < 3; i++)
+        {
+            this_thread::sleep_for(std::chrono::milliseconds(5));
+            (void)q->push(10 + i, tick_timer::now() + std::chrono::milliseconds(delays[i]));
+        }
+    }
+
+    void test_earlier_deadline_wakes_waiter()
+    {
+        queue q;
+        (void)q.push(1, tick_timer::now() + std::chrono::seconds(5));
+        static_thread<4096> producer(push_earlier, &q);
+
+        int value = 0;
+        TEST_CHECK(q.wait_pop_until_due_for(value, std::chrono::seconds(1)));
+        TEST_CHECK(value == 12);
+        producer.join();
+
+        // the repeated wakeups don't leave the waiter spinning, it times out as requested
+        const auto start = tick_timer::now();
+        TEST_CHECK(q.wait_pop_until_due_for(value, std::chrono::milliseconds(5)) == false);
+        TEST_CHECK((tick_timer::now() - start) >= std::chrono::milliseconds(5));
+        TEST_CHECK(q.size() == 3);
+    }
+}
+
+int main()
+{
+    test_cancel();
+    test_cancel_while_waiting();
+    test_earlier_deadline_wakes_waiter();
+    return test::result();
+}
@@ -0,0 +1,112 @@
+/**
+ * @file      deferred_log_test.cpp
+ * @brief     Tests of the deferred log's record layout
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test.h"
+#include "threadx/deferred_log.h"
+#include "threadx/thread.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace threadx;
+
+namespace
+{
+    std::vector<deferred_log::word> stream;
+    std::vector<std::size_t> sizes;
+
+    void collect(const deferred_log::word *record, std::size_t count)
+    {
+        stream.insert(stream.end(), record, record + count);
+        sizes.push_back(count);
+    }
+
+    std::uintptr_t pointer_at(std::size_t pos)
+    {
+        std::uintptr_t value;
+        std::memcpy(&value, &stream[pos], sizeof(value));
+        return value;
+    }
+
+    const char first_format[] = "first";
+
+    void test_record_layout()
+    {
+        TEST_CHECK(deferred_log::write(first_format, 1, 2));
+        TEST_CHECK(deferred_log::drain(collect) == 1);
+
+        // the stream header precedes the records
+        TEST_CHECK((sizes.size() == 2) && (sizes[0] == 3));
+        TEST_CHECK(stream[0] == 0x4C530003);
+        const std::uint8_t *mark = reinterpret_cast<const std::uint8_t*>(&stream[1]);
+        const bool little_endian = *reinterpret_cast<const std::uint8_t*>(&sizes[0]) == 3;
+        TEST_CHECK(mark[0] == (little_endian ? 0x04 : 0x01));
+        TEST_CHECK(stream[2] == (sizeof(void*) | (sizeof(long) << 8)));
+
+        // the address and the thread id aren't truncated
+        const std::size_t record = 3;
+        TEST_CHECK(sizes[1] == deferred_log::HEADER_WORDS + 2);
+        TEST_CHECK(stream[record] == (0x4C470000 | sizes[1]));
+        TEST_CHECK(pointer_at(record + 1) == reinterpret_cast<std::uintptr_t>(first_format));
+        TEST_CHECK(pointer_at(record + 2 + deferred_log::POINTER_WORDS) == this_thread::get_id());
+        TEST_CHECK(stream[record + deferred_log::HEADER_WORDS] == 1);
+        TEST_CHECK(stream[record + deferred_log::HEADER_WORDS + 1] == 2);
+
+        // nothing to ship, no stream header either
+        TEST_CHECK(deferred_log::drain(collect) == 0);
+        TEST_CHECK(sizes.size() == 2);
+    }
+
+    // the stream is decoded by tools/log_decode.py, which checks the formatting of the arguments
+    void write_stream(const char *path)
+    {
+        stream.clear();
+        sizes.clear();
+        const char *text = "text";
+        THREADX_LOG("int %d unsigned %u hex %x", -42, 42u, 0xbeefu);
+        THREADX_LOG("long %ld long long %lld", -1234567890123L, 9876543210123LL);
+        THREADX_LOG("double %.3f char %c", 3.25, 'z');
+        THREADX_LOG("pointer %p", static_cast<const void*>(text));
+        TEST_CHECK(deferred_log::drain(collect) == 4);
+
+        FILE *f = std::fopen(path, "wb");
+        TEST_CHECK(f != nullptr);
+        if (f != nullptr)
+        {
+            std::fwrite(stream.data(), sizeof(stream[0]), stream.size(), f);
+            std::fclose(f);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    test_record_layout();
+    if (argc > 1)
+    {
+        write_stream(argv[1]);
+    }
+    return test::result();
+}
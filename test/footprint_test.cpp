@@ -0,0 +1,69 @@
+/**
+ * @file      footprint_test.cpp
+ * @brief     Compile-time tests of the footprint calculator
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test.h"
+#include "threadx/footprint.h"
+#include "threadx/mutex.h"
+#include "threadx/parallel.h"
+#include "threadx/semaphore.h"
+#include "threadx/thread.h"
+#include "threadx/thread_pool.h"
+
+using namespace threadx;
+
+// the footprint is checked at compile time, building the test is the test
+
+// kernel objects without stacks
+static_assert(footprint<>::value == 0, "");
+static_assert(footprint<mutex>::value == sizeof(mutex), "");
+static_assert(footprint<mutex>::stack == 0, "");
+static_assert(footprint<binary_semaphore>::control == sizeof(binary_semaphore), "");
+static_assert(footprint<counting_semaphore<>[4]>::value == (4 * sizeof(counting_semaphore<>)), "");
+
+// the stacks are accounted separately from the control blocks
+static_assert(footprint<static_thread<1024>>::value == sizeof(static_thread<1024>), "");
+static_assert(footprint<static_thread<1024>>::stack == 1024, "");
+static_assert(footprint<static_thread<1024>>::control >= sizeof(thread), "");
+static_assert(footprint<static_thread<512>[3]>::stack == (3 * 512), "");
+static_assert(footprint<static_thread_pool<1024, 3>>::stack == (3 * 1024), "");
+static_assert(footprint<static_thread_pool<1024, 3>>::value == sizeof(static_thread_pool<1024, 3>), "");
+static_assert(footprint<static_worker_team<1024, 2>>::stack == (2 * 1024), "");
+static_assert(footprint<static_worker_team<1024, 0>>::stack == 0, "");
+
+// the totals of an application's objects
+using application = footprint<static_thread<2048>, static_thread<1024>[2], mutex, binary_semaphore[2]>;
+static_assert(application::value ==
+        (sizeof(static_thread<2048>) + 2 * sizeof(static_thread<1024>) + sizeof(mutex) + 2 * sizeof(binary_semaphore)), "");
+static_assert(application::stack == (2048 + 2 * 1024), "");
+static_assert(application::control == (application::value - application::stack), "");
+
+static_assert(ram_budget<64 * 1024, static_thread<2048>, static_thread<1024>[2], mutex, binary_semaphore[2]>::value, "");
+static_assert(ram_budget<64 * 1024, static_thread<2048>, static_thread<1024>[2], mutex, binary_semaphore[2]>::remaining ==
+        (64 * 1024 - application::value), "");
+
+int main()
+{
+    return test::result();
+}
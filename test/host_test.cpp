@@ -0,0 +1,166 @@
+/**
+ * @file      host_test.cpp
+ * @brief     Tests of the host backend
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test.h"
+#include "threadx/mutex.h"
+#include "threadx/semaphore.h"
+#include "threadx/thread.h"
+#include "threadx/tick_timer.h"
+#include <atomic>
+
+namespace threadx
+{
+    namespace native
+    {
+        #include "tx_api.h"
+    }
+}
+using namespace threadx;
+using namespace threadx::native;
+
+namespace
+{
+    mutex counter_mutex;
+    long counter = 0;
+
+    void increment(int *count)
+    {
+        for (int i = 0; i < *count; i++)
+        {
+            lock_guard<mutex> lock(counter_mutex);
+            counter++;
+        }
+    }
+
+    void test_mutual_exclusion()
+    {
+        int count = 100000;
+        {
+            static_thread<4096> a(increment, &count), b(increment, &count), c(increment, &count);
+            a.join();
+            b.join();
+            c.join();
+        }
+        TEST_CHECK(counter == 3 * count);
+    }
+
+    void test_semaphore_timeout()
+    {
+        binary_semaphore sem;
+        auto start = tick_timer::now();
+        TEST_CHECK(!sem.try_acquire_for(std::chrono::milliseconds(20)));
+        TEST_CHECK((tick_timer::now() - start) >= std::chrono::milliseconds(20));
+
+        sem.release();
+        TEST_CHECK(sem.try_acquire_for(std::chrono::milliseconds(20)));
+    }
+
+    std::atomic<int> expirations { 0 };
+
+    void expire(native::ULONG)
+    {
+        expirations++;
+    }
+
+    void test_periodic_timer()
+    {
+        static char name[] = "periodic";
+        native::TX_TIMER timer;
+        auto result = native::tx_timer_create(&timer, name, expire, 0, 10, 10, TX_AUTO_ACTIVATE);
+        TEST_CHECK(result == TX_SUCCESS);
+        this_thread::sleep_for(std::chrono::milliseconds(105));
+        native::tx_timer_deactivate(&timer);
+        native::tx_timer_delete(&timer);
+        TEST_CHECK(expirations == 10);
+    }
+
+    std::atomic<bool> unwound { false };
+
+    struct unwind_marker
+    {
+        ~unwind_marker()
+        {
+            unwound = true;
+        }
+    };
+
+    void block(binary_semaphore *sem)
+    {
+        unwind_marker marker;
+        sem->acquire();
+    }
+
+    void test_terminate_blocked()
+    {
+        binary_semaphore sem;
+        {
+            static_thread<4096> t(block, &sem);
+            this_thread::sleep_for(std::chrono::milliseconds(10));
+            t.detach();
+            // the destructor terminates the blocked thread
+        }
+        TEST_CHECK(unwound);
+    }
+
+    std::atomic<int> progress { 0 };
+    std::atomic<bool> stop { false };
+
+    void count_up(int *)
+    {
+        while (!stop)
+        {
+            progress++;
+            this_thread::yield();
+        }
+    }
+
+    void test_suspend_resume()
+    {
+        static_thread<4096> t(count_up, static_cast<int*>(nullptr));
+        t.suspend();
+        // the suspension takes effect at the thread's next service call
+        this_thread::sleep_for(std::chrono::milliseconds(5));
+        int suspended_at = progress;
+        this_thread::sleep_for(std::chrono::milliseconds(10));
+        TEST_CHECK(progress == suspended_at);
+        TEST_CHECK(t.get_state() == thread::state::suspended);
+
+        t.resume();
+        this_thread::sleep_for(std::chrono::milliseconds(5));
+        TEST_CHECK(progress > suspended_at);
+        stop = true;
+        t.join();
+    }
+}
+
+int main()
+{
+    test_mutual_exclusion();
+    test_semaphore_timeout();
+    test_periodic_timer();
+    test_terminate_blocked();
+    test_suspend_resume();
+    return test::result();
+}
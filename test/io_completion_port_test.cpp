@@ -0,0 +1,290 @@
+/**
+ * @file      io_completion_port_test.cpp
+ * @brief     Tests of the I/O completion port, on a simulated device
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test.h"
+#include "threadx/io_completion_port.h"
+#include "threadx/channel.h"
+#include "threadx/thread.h"
+#include <atomic>
+
+using namespace threadx;
+
+namespace
+{
+    std::atomic<int> handled { 0 };
+
+    void count_handler(io_operation&)
+    {
+        handled++;
+    }
+
+    void test_batches()
+    {
+        io_completion_port port;
+        io_operation ops[5] = { { count_handler }, { count_handler }, { count_handler }, { count_handler }, { count_handler } };
+        for (auto& op : ops)
+        {
+            port.submit(op);
+            TEST_CHECK(op.is_pending());
+        }
+        TEST_CHECK(port.get_outstanding() == 5);
+        for (int i = 0; i < 5; i++)
+        {
+            port.complete(ops[i], i);
+        }
+
+        // the completions are reaped in their order
+        io_operation *reaped[3];
+        TEST_CHECK(port.reap(reaped, 3) == 3);
+        TEST_CHECK((reaped[0] == &ops[0]) && (reaped[1] == &ops[1]) && (reaped[2] == &ops[2]));
+        TEST_CHECK(!ops[2].is_pending() && ops[3].is_pending());
+        TEST_CHECK(port.reap(reaped, 3) == 2);
+        TEST_CHECK((reaped[0] == &ops[3]) && (reaped[1]->get_result() == 4));
+        TEST_CHECK(port.get_outstanding() == 0);
+
+        TEST_CHECK(port.reap_for(reaped, 3, std::chrono::milliseconds(10)) == 0);
+    }
+
+    io_completion_port *resubmit_port;
+
+    void resubmit_handler(io_operation& op)
+    {
+        handled++;
+        if (op.get_result() == 0)
+        {
+            resubmit_port->submit(op);
+            resubmit_port->complete(op, 1);
+        }
+    }
+
+    void test_dispatch_resubmit()
+    {
+        io_completion_port port;
+        resubmit_port = &port;
+        io_operation ops[3] = { { resubmit_handler }, { resubmit_handler }, { resubmit_handler } };
+        for (auto& op : ops)
+        {
+            port.submit(op);
+            port.complete(op, 0);
+        }
+
+        // each handler queues its operation again behind the batch
+        handled = 0;
+        TEST_CHECK(port.dispatch(8) == 3);
+        TEST_CHECK(handled == 3);
+        TEST_CHECK(port.get_outstanding() == 3);
+        TEST_CHECK(port.dispatch(8) == 3);
+        TEST_CHECK(handled == 6);
+        TEST_CHECK(port.get_outstanding() == 0);
+    }
+
+    struct resubmitter
+    {
+        io_completion_port port;
+        io_operation op { count_handler };
+        std::atomic<bool> armed { false };
+        std::atomic<bool> stop { false };
+    };
+
+    void resubmit_when_reaped(resubmitter *r)
+    {
+        while (!r->stop)
+        {
+            if (r->armed && !r->op.is_pending())
+            {
+                r->port.submit(r->op);
+                r->port.complete(r->op, 1);
+                r->armed = false;
+            }
+            this_thread::yield();
+        }
+    }
+
+    void test_resubmit_while_reaping()
+    {
+        // the first operation of each batch is resubmitted as soon as it's reaped,
+        // racing with the reaping of the rest of the batch, which must stay intact
+        resubmitter r;
+        io_operation others[2] = { { count_handler }, { count_handler } };
+        static_thread<4096> t(resubmit_when_reaped, &r);
+        for (int i = 0; i < 200; i++)
+        {
+            r.port.submit(r.op);
+            r.port.submit(others[0]);
+            r.port.submit(others[1]);
+            r.port.complete(r.op, 0);
+            r.port.complete(others[0], 0);
+            r.port.complete(others[1], 0);
+            r.armed = true;
+
+            io_operation *reaped[3];
+            TEST_CHECK(r.port.reap(reaped, 3) == 3);
+            TEST_CHECK((reaped[1] == &others[0]) && (reaped[2] == &others[1]));
+            TEST_CHECK(r.port.reap(reaped, 3) == 1);
+            TEST_CHECK(reaped[0] == &r.op);
+            TEST_CHECK(r.port.get_outstanding() == 0);
+            while (r.armed)
+            {
+                this_thread::yield();
+            }
+        }
+        r.stop = true;
+        t.join();
+    }
+
+    // a DMA capable device, which transfers the requests one after the other,
+    // and signals their completion from its interrupt
+    class simulated_device
+    {
+    public:
+        struct transfer : public io_operation
+        {
+            simulated_device *device;
+            std::size_t length;
+            std::size_t chunks;
+
+            transfer()
+                : io_operation(transfer::on_completion), device(nullptr), length(0), chunks(0)
+            {
+            }
+
+            // the driver's completion handler, chaining the chunks of a transfer
+            static void on_completion(io_operation& op)
+            {
+                auto& t = static_cast<transfer&>(op);
+                t.device->transferred_ += static_cast<std::size_t>(t.get_result());
+                if (--t.chunks > 0)
+                {
+                    t.device->start(t);
+                }
+                else
+                {
+                    t.device->finished_++;
+                }
+            }
+        };
+
+        void start(transfer& t)
+        {
+            t.device = this;
+            port_.submit(t);
+            (void)requests_.send(&t);
+        }
+
+        void shutdown()
+        {
+            requests_.close();
+            engine_.join();
+        }
+
+        std::size_t get_transferred() const
+        {
+            return transferred_;
+        }
+
+        int get_finished() const
+        {
+            return finished_;
+        }
+
+        simulated_device(io_completion_port& port)
+            : port_(port), transferred_(0), finished_(0), engine_(simulated_device::run, this)
+        {
+        }
+
+    private:
+        static void run(simulated_device *dev)
+        {
+            for (transfer *t : dev->requests_)
+            {
+                this_thread::sleep_for(std::chrono::milliseconds(1));
+                dev->port_.complete(*t, static_cast<io_operation::result_type>(t->length));
+            }
+        }
+
+        io_completion_port& port_;
+        channel<transfer*, 16> requests_;
+        std::atomic<std::size_t> transferred_;
+        std::atomic<int> finished_;
+        static_thread<4096> engine_;
+    };
+
+    struct reaper_context
+    {
+        io_completion_port *port;
+        std::atomic<bool> running;
+    };
+
+    void reap_completions(reaper_context *ctx)
+    {
+        while (ctx->running)
+        {
+            io_operation *ops[4];
+            std::size_t n = ctx->port->reap_for(ops, 4, std::chrono::milliseconds(5));
+            for (std::size_t i = 0; i < n; i++)
+            {
+                simulated_device::transfer::on_completion(*ops[i]);
+            }
+        }
+    }
+
+    void test_simulated_device()
+    {
+        // many outstanding transfers are multiplexed over two reaping threads
+        io_completion_port port;
+        simulated_device dev(port);
+        reaper_context ctx { &port, { true } };
+        static_thread<4096> reaper1(reap_completions, &ctx), reaper2(reap_completions, &ctx);
+
+        simulated_device::transfer transfers[12];
+        for (std::size_t i = 0; i < 12; i++)
+        {
+            transfers[i].length = 64 * (i + 1);
+            transfers[i].chunks = 3;
+            dev.start(transfers[i]);
+        }
+        for (int i = 0; (i < 1000) && (dev.get_finished() < 12); i++)
+        {
+            this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        TEST_CHECK(dev.get_finished() == 12);
+        TEST_CHECK(dev.get_transferred() == 3 * 64 * (12 * 13 / 2));
+        TEST_CHECK(port.get_outstanding() == 0);
+        ctx.running = false;
+        reaper1.join();
+        reaper2.join();
+        dev.shutdown();
+    }
+}
+
+int main()
+{
+    test_batches();
+    test_dispatch_resubmit();
+    test_resubmit_while_reaping();
+    test_simulated_device();
+    return test::result();
+}
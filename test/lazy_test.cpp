@@ -0,0 +1,138 @@
+/**
+ * @file      lazy_test.cpp
+ * @brief     Tests of the lazy initialization
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test.h"
+#include "threadx/lazy.h"
+#include "threadx/thread.h"
+#include <atomic>
+
+using namespace threadx;
+
+namespace
+{
+    constexpr int USERS = 4;
+
+    std::atomic<int> constructions { 0 };
+
+    struct slow_object
+    {
+        int value;
+
+        explicit slow_object(int v)
+            : value(0)
+        {
+            constructions++;
+            // the competing users arrive during the construction
+            this_thread::sleep_for(std::chrono::milliseconds(20));
+            value = v;
+        }
+    };
+
+    lazy<slow_object> shared;
+
+    struct user
+    {
+        int arg;
+        slow_object *seen;
+        int value;
+    };
+
+    slow_object& local_singleton()
+    {
+        static slow_object local(USERS + 1);
+        return local;
+    }
+
+    void use(user *u)
+    {
+        slow_object& obj = shared.get(u->arg);
+        u->seen = &obj;
+        u->value = obj.value;
+    }
+
+    void use_local(user *u)
+    {
+        slow_object& obj = local_singleton();
+        u->seen = &obj;
+        u->value = obj.value;
+    }
+
+    void run_users(user *users, void (*func)(user*))
+    {
+        static_thread<4096> t0(func, &users[0]);
+        static_thread<4096> t1(func, &users[1]);
+        static_thread<4096> t2(func, &users[2]);
+        static_thread<4096> t3(func, &users[3]);
+        t0.join();
+        t1.join();
+        t2.join();
+        t3.join();
+    }
+
+    void test_single_construction()
+    {
+        TEST_CHECK(!shared.is_initialized());
+
+        user users[USERS];
+        for (int i = 0; i < USERS; i++)
+        {
+            users[i] = user { i + 1, nullptr, 0 };
+        }
+        run_users(users, use);
+
+        // a single user constructed it, the others waited for the finished object
+        TEST_CHECK(constructions == 1);
+        TEST_CHECK(shared.is_initialized());
+        // later arguments are ignored
+        slow_object& obj = shared.get(100);
+        TEST_CHECK((obj.value >= 1) && (obj.value <= USERS));
+        for (auto& u : users)
+        {
+            TEST_CHECK(u.seen == &obj);
+            TEST_CHECK(u.value == obj.value);
+        }
+        TEST_CHECK(constructions == 1);
+    }
+
+    void test_function_local_static()
+    {
+        // the __cxa_guard hooks make the competing users wait for the construction
+        user users[USERS] {};
+        run_users(users, use_local);
+        TEST_CHECK(constructions == 2);
+        for (auto& u : users)
+        {
+            TEST_CHECK(u.seen == &local_singleton());
+            TEST_CHECK(u.value == (USERS + 1));
+        }
+    }
+}
+
+int main()
+{
+    test_single_construction();
+    test_function_local_static();
+    return test::result();
+}
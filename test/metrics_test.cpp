@@ -0,0 +1,163 @@
+/**
+ * @file      metrics_test.cpp
+ * @brief     Tests of the metrics
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test.h"
+#include "threadx/metrics.h"
+#include "threadx/thread.h"
+#include <cstring>
+
+using namespace threadx;
+
+namespace
+{
+    constexpr int ADDS = 10000;
+
+    counter events("events");
+    gauge depth("depth");
+    histogram latency("latency");
+
+    bool is_registered(const metric *m)
+    {
+        for (auto *it = metric::get_first(); it != nullptr; it = it->get_next())
+        {
+            if (it == m)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void test_registry()
+    {
+        // the list follows the order of registration
+        const metric *m = metric::get_first();
+        TEST_CHECK((m != nullptr) && (std::strcmp(m->get_name(), "events") == 0));
+        TEST_CHECK((m != nullptr) && (m->get_kind() == metric::kind::counter));
+        m = (m != nullptr) ? m->get_next() : nullptr;
+        TEST_CHECK((m != nullptr) && (m->get_kind() == metric::kind::gauge));
+        m = (m != nullptr) ? m->get_next() : nullptr;
+        TEST_CHECK((m != nullptr) && (m->get_kind() == metric::kind::histogram));
+        TEST_CHECK((m != nullptr) && (m->get_next() == nullptr));
+
+        // a destroyed metric leaves the list
+        const metric *scoped_metric;
+        {
+            counter scoped("scoped");
+            scoped_metric = &scoped;
+            TEST_CHECK(is_registered(scoped_metric));
+        }
+        TEST_CHECK(!is_registered(scoped_metric));
+        TEST_CHECK(is_registered(&latency));
+    }
+
+    void count_events(counter *c)
+    {
+        for (int i = 0; i < ADDS; i++)
+        {
+            c->add();
+        }
+    }
+
+    void test_counter_merges_shards()
+    {
+        {
+            static_thread<4096> t0(count_events, &events);
+            static_thread<4096> t1(count_events, &events);
+            static_thread<4096> t2(count_events, &events);
+            count_events(&events);
+            t0.join();
+            t1.join();
+            t2.join();
+        }
+        TEST_CHECK(events.get_value() == (4 * ADDS));
+        events.add(5);
+        TEST_CHECK(events.get_value() == (4 * ADDS + 5));
+    }
+
+    void test_gauge_high_watermark()
+    {
+        depth.set(3);
+        depth.add(4);
+        depth.add(-6);
+        TEST_CHECK(depth.get_value() == 1);
+        TEST_CHECK(depth.get_max() == 7);
+        depth.reset_max();
+        TEST_CHECK(depth.get_max() == 1);
+        depth.set(-2);
+        TEST_CHECK(depth.get_max() == 1);
+    }
+
+    void test_histogram_buckets()
+    {
+        // each value falls into the bucket bounded by it, with bounded relative error
+        bool contained = true;
+        bool bounded = true;
+        for (std::uint64_t v = 0; v <= 0xFFFFFFFFull; v = (v < 4096) ? (v + 1) : (v * 5 / 4 + 1))
+        {
+            const auto value = static_cast<histogram::value_type>(v);
+            const unsigned b = histogram::bucket_of(value);
+            const auto upper = histogram::bucket_upper_bound(b);
+            contained = contained && (b < histogram::BUCKET_COUNT) && (value <= upper) &&
+                    ((b == 0) || (histogram::bucket_upper_bound(b - 1) < value));
+            bounded = bounded && ((upper - value) <= (value / histogram::SUB_BUCKETS));
+        }
+        TEST_CHECK(contained);
+        TEST_CHECK(bounded);
+        TEST_CHECK(histogram::bucket_of(0xFFFFFFFFu) == (histogram::BUCKET_COUNT - 1));
+        TEST_CHECK(histogram::bucket_upper_bound(histogram::BUCKET_COUNT - 1) == 0xFFFFFFFFu);
+    }
+
+    void test_histogram_quantiles()
+    {
+        for (histogram::value_type v = 1; v <= 100; v++)
+        {
+            latency.record(v);
+        }
+        histogram::snapshot s;
+        latency.get_snapshot(s);
+        TEST_CHECK(s.get_count() == 100);
+        const auto median = s.get_quantile(0.5f);
+        TEST_CHECK((median >= 50) && (median <= 50 + 50 / histogram::SUB_BUCKETS));
+        const auto max = s.get_quantile(1.0f);
+        TEST_CHECK((max >= 100) && (max <= 100 + 100 / histogram::SUB_BUCKETS));
+        TEST_CHECK(s.get_quantile(0.0f) == 1);
+
+        // merging doubles the counts, the quantiles remain
+        s.merge(s);
+        TEST_CHECK(s.get_count() == 200);
+        TEST_CHECK(s.get_quantile(0.5f) == median);
+    }
+}
+
+int main()
+{
+    test_registry();
+    test_counter_merges_shards();
+    test_gauge_high_watermark();
+    test_histogram_buckets();
+    test_histogram_quantiles();
+    return test::result();
+}
@@ -0,0 +1,127 @@
+/**
+ * @file      parallel_test.cpp
+ * @brief     Tests of the worker team and the parallel algorithms
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <atomic>
+#include "test.h"
+#include "threadx/parallel.h"
+
+using namespace threadx;
+
+namespace
+{
+    constexpr std::size_t COUNT = 1000;
+
+    struct coverage
+    {
+        std::atomic<int> visits[COUNT];
+        std::atomic<std::size_t> max_participant;
+
+        coverage()
+            : max_participant(0)
+        {
+            for (auto& v : visits)
+            {
+                v.store(0);
+            }
+        }
+
+        static void chunk(void *context, std::size_t first, std::size_t last, std::size_t participant)
+        {
+            auto& c = *static_cast<coverage*>(context);
+            for (std::size_t i = first; i < last; i++)
+            {
+                c.visits[i]++;
+            }
+            std::size_t seen = c.max_participant.load();
+            while ((participant > seen) && !c.max_participant.compare_exchange_weak(seen, participant))
+            {
+            }
+        }
+
+        bool each_once(std::size_t first, std::size_t last) const
+        {
+            for (std::size_t i = 0; i < COUNT; i++)
+            {
+                if (visits[i].load() != (((i >= first) && (i < last)) ? 1 : 0))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    template<class Team>
+    void test_run_covers_range(Team& team, partition p)
+    {
+        // every index is processed exactly once, by a valid participant
+        coverage c;
+        team.run(10, COUNT - 10, 7, p, &coverage::chunk, &c);
+        TEST_CHECK(c.each_once(10, COUNT - 10));
+        TEST_CHECK(c.max_participant.load() < team.size());
+
+        // an empty range calls nothing
+        coverage empty;
+        team.run(5, 5, 7, p, &coverage::chunk, &empty);
+        TEST_CHECK(empty.each_once(0, 0));
+    }
+
+    template<class Team>
+    void test_parallel_for_and_reduce(Team& team)
+    {
+        std::atomic<int> hits[COUNT];
+        for (auto& h : hits)
+        {
+            h.store(0);
+        }
+        parallel_for(team, 0, COUNT, 16, [&hits](std::size_t i) { hits[i]++; }, partition::fixed);
+        parallel_for(team, 0, COUNT, 16, [&hits](std::size_t i) { hits[i]++; });
+        bool twice = true;
+        for (auto& h : hits)
+        {
+            twice = twice && (h.load() == 2);
+        }
+        TEST_CHECK(twice);
+
+        const std::size_t sum = parallel_reduce(team, 0, COUNT, 16, std::size_t(0),
+                [](std::size_t i) { return i; },
+                [](std::size_t a, std::size_t b) { return a + b; });
+        TEST_CHECK(sum == (COUNT * (COUNT - 1) / 2));
+    }
+}
+
+int main()
+{
+    static_worker_team<4096, 3> team;
+    TEST_CHECK(team.size() == 4);
+    test_run_covers_range(team, partition::fixed);
+    test_run_covers_range(team, partition::dynamic);
+    test_parallel_for_and_reduce(team);
+
+    // without workers the algorithms run in the caller
+    static_worker_team<4096, 0> alone;
+    test_parallel_for_and_reduce(alone);
+    return test::result();
+}
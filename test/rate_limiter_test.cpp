@@ -0,0 +1,74 @@
+/**
+ * @file      rate_limiter_test.cpp
+ * @brief     Tests of the token bucket rate limiter
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test.h"
+#include "threadx/rate_limiter.h"
+#include "threadx/thread.h"
+
+using namespace threadx;
+
+namespace
+{
+    void test_burst_and_refill()
+    {
+        rate_limiter limiter(4, 2, std::chrono::milliseconds(20));
+        TEST_CHECK(limiter.max() == 4);
+        TEST_CHECK(limiter.get_count() == 4);
+
+        // the full bucket allows a burst
+        TEST_CHECK(limiter.try_acquire(3));
+        TEST_CHECK(limiter.try_acquire());
+        TEST_CHECK(!limiter.try_acquire());
+        TEST_CHECK(limiter.get_count() == 0);
+
+        // a period adds its tokens, and the bucket doesn't overflow
+        this_thread::sleep_for(std::chrono::milliseconds(25));
+        TEST_CHECK(limiter.get_count() >= 2);
+        this_thread::sleep_for(std::chrono::milliseconds(100));
+        TEST_CHECK(limiter.get_count() == 4);
+    }
+
+    void test_blocking_acquire()
+    {
+        rate_limiter limiter(2, 1, std::chrono::milliseconds(10));
+        limiter.acquire(2);
+
+        // the caller sleeps until the tokens are refilled
+        const auto start = tick_timer::now();
+        limiter.acquire(2);
+        TEST_CHECK((tick_timer::now() - start) >= std::chrono::milliseconds(10));
+
+        // not enough tokens arrive in time
+        TEST_CHECK(!limiter.try_acquire_for(2, std::chrono::milliseconds(5)));
+        TEST_CHECK(limiter.try_acquire_for(2, std::chrono::milliseconds(50)));
+    }
+}
+
+int main()
+{
+    test_burst_and_refill();
+    test_blocking_acquire();
+    return test::result();
+}
@@ -0,0 +1,98 @@
+/**
+ * @file      rpc_server_test.cpp
+ * @brief     Tests of the RPC server's priority donation
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test.h"
+#include "threadx/rpc_server.h"
+
+using namespace threadx;
+
+namespace
+{
+    using server_type = rpc_server<int, thread::priority::value_type>;
+    constexpr thread::priority SERVER_PRIORITY = 10;
+
+    struct context
+    {
+        server_type server;
+        int served = 0;
+    };
+
+    // responds with the server thread's priority during the call
+    void serve(context *ctx)
+    {
+        while (ctx->served < 3)
+        {
+            ctx->server.serve_one([](const int&, thread::priority::value_type& prio)
+            {
+                prio = thread::get_current()->get_priority();
+            });
+            ctx->served++;
+        }
+    }
+
+    struct call_context
+    {
+        context *ctx;
+        thread::priority::value_type observed;
+    };
+
+    void call(call_context *cc)
+    {
+        server_type::client client(cc->ctx->server);
+        client.call(0, cc->observed);
+    }
+
+    void test_priority_donation()
+    {
+        context ctx;
+        static_thread<4096> server(serve, &ctx, SERVER_PRIORITY);
+
+        // the urgent caller raises the server, the others don't lower it
+        call_context urgent { &ctx, 0 }, equal { &ctx, 0 }, background { &ctx, 0 };
+        {
+            static_thread<4096> t(call, &urgent, 5);
+            t.join();
+        }
+        {
+            static_thread<4096> t(call, &background, 20);
+            t.join();
+        }
+        {
+            static_thread<4096> t(call, &equal, SERVER_PRIORITY);
+            t.join();
+        }
+        server.join();
+
+        TEST_CHECK(urgent.observed == 5);
+        TEST_CHECK(background.observed == SERVER_PRIORITY);
+        TEST_CHECK(equal.observed == SERVER_PRIORITY);
+    }
+}
+
+int main()
+{
+    test_priority_donation();
+    return test::result();
+}
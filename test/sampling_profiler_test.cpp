@@ -0,0 +1,159 @@
+/**
+ * @file      sampling_profiler_test.cpp
+ * @brief     Tests of the sampling profiler
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test.h"
+#include "threadx/sampling_profiler.h"
+#include "threadx/thread.h"
+#include <cstdio>
+#include <vector>
+
+using namespace threadx;
+
+namespace
+{
+    constexpr std::size_t PROFILER_SIZE = 256;
+
+    std::vector<sampling_profiler::sample> samples;
+
+    void collect(const sampling_profiler::sample *batch, std::size_t count)
+    {
+        samples.insert(samples.end(), batch, batch + count);
+    }
+
+    std::uint32_t sample_id(thread::id id)
+    {
+        return static_cast<std::uint32_t>(id);
+    }
+
+    const void* pc_of(std::uintptr_t address)
+    {
+        return reinterpret_cast<const void*>(address);
+    }
+
+    void tick_in_thread(int *count)
+    {
+        for (int i = 0; i < *count; i++)
+        {
+            sampling_profiler::on_tick(pc_of(0x2000));
+        }
+    }
+
+    void test_samples_running_thread()
+    {
+        // nothing is sampled until started
+        sampling_profiler::on_tick(pc_of(0x1000));
+        TEST_CHECK(sampling_profiler::drain(collect) == 0);
+
+        sampling_profiler::start();
+        sampling_profiler::on_tick(pc_of(0x1000));
+        sampling_profiler::on_tick();
+        int count = 3;
+        thread::id worker_id;
+        {
+            static_thread<4096> worker(tick_in_thread, &count);
+            worker_id = worker.get_id();
+            worker.join();
+        }
+        sampling_profiler::stop();
+        sampling_profiler::on_tick(pc_of(0x1000));
+
+        TEST_CHECK(sampling_profiler::drain(collect) == 5);
+        TEST_CHECK(samples.size() == 5);
+        std::size_t own = 0, worker = 0;
+        for (auto& s : samples)
+        {
+            if (s.thread == sample_id(this_thread::get_id()))
+            {
+                TEST_CHECK((s.pc == 0x1000) || (s.pc == 0));
+                own++;
+            }
+            else if (s.thread == sample_id(worker_id))
+            {
+                TEST_CHECK(s.pc == 0x2000);
+                worker++;
+            }
+        }
+        TEST_CHECK((own == 2) && (worker == 3));
+        TEST_CHECK(sampling_profiler::get_dropped() == 0);
+        samples.clear();
+    }
+
+    void test_full_buffer_drops()
+    {
+        sampling_profiler::start();
+        for (std::size_t i = 0; i < (PROFILER_SIZE + 10); i++)
+        {
+            sampling_profiler::on_tick(pc_of(0x1000 + i));
+        }
+        TEST_CHECK(sampling_profiler::get_dropped() == 10);
+
+        // the buffer wraps around, the oldest samples are kept in order
+        TEST_CHECK(sampling_profiler::drain(collect) == PROFILER_SIZE);
+        bool ordered = samples.size() == PROFILER_SIZE;
+        for (std::size_t i = 0; ordered && (i < samples.size()); i++)
+        {
+            ordered = samples[i].pc == (0x1000 + i);
+        }
+        TEST_CHECK(ordered);
+
+        sampling_profiler::on_tick(pc_of(0x3000));
+        TEST_CHECK(sampling_profiler::drain(collect) == 1);
+        TEST_CHECK(samples.back().pc == 0x3000);
+        sampling_profiler::stop();
+        samples.clear();
+    }
+
+    // the samples are folded by tools/profile_fold.py
+    void write_samples(const char *path)
+    {
+        sampling_profiler::start();
+        for (int i = 0; i < 3; i++)
+        {
+            sampling_profiler::on_tick(pc_of(0x100));
+        }
+        sampling_profiler::on_tick(pc_of(0x200));
+        sampling_profiler::stop();
+        TEST_CHECK(sampling_profiler::drain(collect) == 4);
+
+        FILE *f = std::fopen(path, "wb");
+        TEST_CHECK(f != nullptr);
+        if (f != nullptr)
+        {
+            std::fwrite(samples.data(), sizeof(samples[0]), samples.size(), f);
+            std::fclose(f);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    test_samples_running_thread();
+    test_full_buffer_drops();
+    if (argc > 1)
+    {
+        write_samples(argv[1]);
+    }
+    return test::result();
+}
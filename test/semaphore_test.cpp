@@ -0,0 +1,152 @@
+/**
+ * @file      semaphore_test.cpp
+ * @brief     Tests of the semaphore and mutex reinitialization
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test.h"
+#include "threadx/mutex.h"
+#include "threadx/semaphore.h"
+#include "threadx/thread.h"
+#include <atomic>
+
+using namespace threadx;
+
+namespace
+{
+    std::atomic<int> acquired { 0 };
+
+    void acquire(counting_semaphore<> *sem)
+    {
+        sem->acquire();
+        acquired++;
+    }
+
+    void test_reset_without_waiters()
+    {
+        counting_semaphore<> sem(5);
+        sem.reset(2);
+        TEST_CHECK(sem.get_count() == 2);
+        sem.reset();
+        TEST_CHECK(sem.get_count() == 0);
+    }
+
+    void test_reset_hands_over_to_waiters()
+    {
+        counting_semaphore<> sem(0);
+        {
+            static_thread<4096> a(acquire, &sem), b(acquire, &sem);
+            this_thread::sleep_for(std::chrono::milliseconds(10));
+
+            // two of the count go to the waiters, the rest remains
+            sem.reset(3);
+            a.join();
+            b.join();
+        }
+        TEST_CHECK(acquired == 2);
+        TEST_CHECK(sem.get_count() == 1);
+    }
+
+    void test_mutex_unlock_all()
+    {
+        recursive_mutex m;
+        m.lock();
+        m.lock();
+        m.lock();
+        TEST_CHECK(m.get_locking_thread() != nullptr);
+        m.unlock_all();
+        TEST_CHECK(m.get_locking_thread() == nullptr);
+        TEST_CHECK(m.try_lock());
+        m.unlock();
+    }
+
+    void lock_unlock(recursive_mutex *m)
+    {
+        lock_guard<recursive_mutex> lock(*m);
+        acquired++;
+    }
+
+    void test_mutex_unlock_all_hands_over()
+    {
+        recursive_mutex m;
+        acquired = 0;
+        m.lock();
+        m.lock();
+        {
+            static_thread<4096> waiter(lock_unlock, &m);
+            this_thread::sleep_for(std::chrono::milliseconds(10));
+            m.unlock_all();
+            waiter.join();
+        }
+        TEST_CHECK(acquired == 1);
+        TEST_CHECK(m.get_locking_thread() == nullptr);
+    }
+
+    std::atomic<int> failed { 0 };
+
+    void acquire_deleted(counting_semaphore<> *sem)
+    {
+        if (!sem->try_acquire_for(std::chrono::seconds(5)))
+        {
+            failed++;
+        }
+    }
+
+    void lock_deleted(mutex *m)
+    {
+        if (!m->try_lock_for(std::chrono::seconds(5)))
+        {
+            failed++;
+        }
+    }
+
+    void test_delete_resumes_waiters()
+    {
+        // the waiters return unsuccessfully right away, not at their timeout
+        failed = 0;
+        auto *sem = new counting_semaphore<>(0);
+        auto *m = new mutex();
+        m->lock();
+        const auto start = tick_timer::now();
+        {
+            static_thread<4096> a(acquire_deleted, sem), b(acquire_deleted, sem), c(lock_deleted, m);
+            this_thread::sleep_for(std::chrono::milliseconds(10));
+            delete sem;
+            delete m;
+            a.join();
+            b.join();
+            c.join();
+        }
+        TEST_CHECK(failed == 3);
+        TEST_CHECK((tick_timer::now() - start) < std::chrono::seconds(1));
+    }
+}
+
+int main()
+{
+    test_reset_without_waiters();
+    test_reset_hands_over_to_waiters();
+    test_mutex_unlock_all();
+    test_mutex_unlock_all_hands_over();
+    test_delete_resumes_waiters();
+    return test::result();
+}
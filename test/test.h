@@ -0,0 +1,58 @@
+/**
+ * @file      test.h
+ * @brief     Minimal checks for the host tests
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __THREADX_TEST_H_
+#define __THREADX_TEST_H_
+
+#include <cstdio>
+
+namespace test
+{
+    inline int& failures()
+    {
+        static int count = 0;
+        return count;
+    }
+
+    inline void check(bool passed, const char *expr, const char *file, int line)
+    {
+        if (!passed)
+        {
+            std::printf("%s:%d: check failed: %s\n", file, line, expr);
+            failures()++;
+        }
+    }
+
+    /// @brief  Reports the outcome of the test, to be returned from main.
+    inline int result()
+    {
+        std::printf("%s\n", (failures() == 0) ? "PASS" : "FAIL");
+        return (failures() == 0) ? 0 : 1;
+    }
+}
+
+#define TEST_CHECK(expr)    test::check(static_cast<bool>(expr), #expr, __FILE__, __LINE__)
+
+#endif // __THREADX_TEST_H_
@@ -0,0 +1,84 @@
+/**
+ * @file      thread_group_test.cpp
+ * @brief     Tests of the deferred start of thread groups
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test.h"
+#include "threadx/thread_group.h"
+#include <atomic>
+
+using namespace threadx;
+
+namespace
+{
+    void mark(std::atomic<int> *flag)
+    {
+        (*flag)++;
+    }
+
+    void test_full_group_starts_right_away()
+    {
+        std::atomic<int> ran[3] = { { 0 }, { 0 }, { 0 } };
+        static_thread_group<2> group;
+        static_thread<4096> a(mark, &ran[0]), b(mark, &ran[1]);
+        TEST_CHECK(group.size() == 2);
+
+        // no room left in the group
+        static_thread<4096> c(mark, &ran[2]);
+        TEST_CHECK(group.size() == 2);
+        c.join();
+        TEST_CHECK((ran[0] == 0) && (ran[1] == 0) && (ran[2] == 1));
+
+        group.start_all();
+        TEST_CHECK(group.size() == 0);
+        a.join();
+        b.join();
+        TEST_CHECK((ran[0] == 1) && (ran[1] == 1));
+    }
+
+    void test_destroyed_thread_leaves_group()
+    {
+        std::atomic<int> ran[3] = { { 0 }, { 0 }, { 0 } };
+        static_thread_group<4> group;
+        static_thread<4096> a(mark, &ran[0]);
+        {
+            static_thread<4096> b(mark, &ran[1]);
+            TEST_CHECK(group.size() == 2);
+        }
+        TEST_CHECK(group.size() == 1);
+        static_thread<4096> c(mark, &ran[2]);
+        TEST_CHECK(group.size() == 2);
+
+        group.start_all();
+        a.join();
+        c.join();
+        TEST_CHECK((ran[0] == 1) && (ran[1] == 0) && (ran[2] == 1));
+    }
+}
+
+int main()
+{
+    test_full_group_starts_right_away();
+    test_destroyed_thread_leaves_group();
+    return test::result();
+}
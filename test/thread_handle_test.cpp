@@ -0,0 +1,95 @@
+/**
+ * @file      thread_handle_test.cpp
+ * @brief     Tests of the thread_handle
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test.h"
+#include "threadx/thread.h"
+#include <atomic>
+#include <utility>
+
+using namespace threadx;
+
+namespace
+{
+    std::atomic<int> finished { 0 };
+
+    void work(int *delay_ms)
+    {
+        this_thread::sleep_for(std::chrono::milliseconds(*delay_ms));
+        finished++;
+    }
+
+    void test_move_transfers_ownership()
+    {
+        int delay = 10;
+        static_thread<4096> t(work, &delay);
+
+        thread_handle a(t, true);
+        thread_handle b(std::move(a));
+        TEST_CHECK(!a);
+        TEST_CHECK(!a.joinable());
+        TEST_CHECK(a.get_id() == 0);
+        TEST_CHECK(b.get() == &t);
+        TEST_CHECK(b.joinable());
+
+        b.join();
+        TEST_CHECK(!b);
+        TEST_CHECK(finished == 1);
+    }
+
+    void test_owning_handle_joins_on_destruction()
+    {
+        int delay = 10;
+        static_thread<4096> t(work, &delay);
+        {
+            thread_handle h(t, true);
+        }
+        TEST_CHECK(finished == 2);
+        TEST_CHECK(!t.joinable());
+    }
+
+    void test_exited_thread_is_joinable()
+    {
+        int delay = 0;
+        static_thread<4096> t(work, &delay);
+        for (int i = 0; (i < 1000) && (t.get_state() != thread::state::completed); i++)
+        {
+            this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        // the exit still has to be observed
+        TEST_CHECK(finished == 3);
+        TEST_CHECK(t.joinable());
+        t.join();
+        TEST_CHECK(!t.joinable());
+    }
+}
+
+int main()
+{
+    test_move_transfers_ownership();
+    test_owning_handle_joins_on_destruction();
+    test_exited_thread_is_joinable();
+    return test::result();
+}
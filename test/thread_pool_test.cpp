@@ -0,0 +1,131 @@
+/**
+ * @file      thread_pool_test.cpp
+ * @brief     Tests of the detached threads of a thread pool
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test.h"
+#include "threadx/semaphore.h"
+#include "threadx/thread_pool.h"
+#include <atomic>
+
+using namespace threadx;
+
+namespace
+{
+    constexpr std::size_t SLOTS = 2;
+
+    std::atomic<int> finished { 0 };
+
+    void wait_for_start(counting_semaphore<> *start)
+    {
+        start->acquire();
+        finished++;
+    }
+
+    void finish_now(std::atomic<int> *counter)
+    {
+        (*counter)++;
+    }
+
+    bool wait_available(thread_pool& pool, std::size_t count)
+    {
+        for (int i = 0; (i < 1000) && (pool.available() != count); i++)
+        {
+            this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return pool.available() == count;
+    }
+
+    void test_detached_threads_are_reclaimed()
+    {
+        static_thread_pool<4096, SLOTS> pool;
+        counting_semaphore<> start(0);
+        finished = 0;
+
+        for (std::size_t i = 0; i < SLOTS; i++)
+        {
+            auto h = pool.create(wait_for_start, &start);
+            TEST_CHECK(h);
+            h.detach();
+            TEST_CHECK(!h);
+        }
+        TEST_CHECK(pool.available() == 0);
+        TEST_CHECK(!pool.create(wait_for_start, &start));
+
+        // the exiting threads return their slots without being observed
+        for (std::size_t i = 0; i < SLOTS; i++)
+        {
+            start.release();
+        }
+        TEST_CHECK(wait_available(pool, SLOTS));
+        TEST_CHECK(finished == SLOTS);
+    }
+
+    void test_detach_after_exit_reclaims()
+    {
+        static_thread_pool<4096, SLOTS> pool;
+        finished = 0;
+
+        auto h = pool.create(finish_now, &finished);
+        TEST_CHECK(h);
+        for (int i = 0; (i < 1000) && (finished == 0); i++)
+        {
+            this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        // the finished thread keeps its slot until it's detached
+        TEST_CHECK(finished == 1);
+        TEST_CHECK(pool.available() == (SLOTS - 1));
+        TEST_CHECK(h.joinable());
+        h.detach();
+        TEST_CHECK(wait_available(pool, SLOTS));
+    }
+
+    void test_slots_are_reused()
+    {
+        static_thread_pool<4096, SLOTS> pool;
+        finished = 0;
+
+        // far more threads than slots pass through the pool,
+        // the slot of a joined thread is free by the time the join returns
+        for (int i = 0; i < 50; i++)
+        {
+            pool.create(finish_now, &finished).join();
+            TEST_CHECK(pool.available() == SLOTS);
+        }
+        for (int i = 0; i < 50; i++)
+        {
+            TEST_CHECK(wait_available(pool, SLOTS));
+            pool.create(finish_now, &finished).detach();
+        }
+        TEST_CHECK(wait_available(pool, SLOTS));
+        TEST_CHECK(finished == 100);
+    }
+}
+
+int main()
+{
+    test_detached_threads_are_reclaimed();
+    test_detach_after_exit_reclaims();
+    test_slots_are_reused();
+    return test::result();
+}
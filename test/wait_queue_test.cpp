@@ -0,0 +1,135 @@
+/**
+ * @file      wait_queue_test.cpp
+ * @brief     Tests of the wait queue timeouts
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test.h"
+#include "threadx/wait_queue.h"
+#include "threadx/thread.h"
+
+using namespace threadx;
+
+namespace
+{
+    // a minimal event flag built on the wait queue
+    struct event
+    {
+        cpu::critical_section cs;
+        wait_queue waiters;
+        bool set = false;
+        int woken = 0;
+
+        event(wait_queue::order o = wait_queue::order::fifo)
+            : waiters(o)
+        {
+        }
+    };
+
+    void test_wait_times_out()
+    {
+        event e;
+        wait_queue::lock_type lock(e.cs);
+
+        const auto start = tick_timer::now();
+        TEST_CHECK(!e.waiters.wait_for(lock, std::chrono::milliseconds(20)));
+        TEST_CHECK((tick_timer::now() - start) >= std::chrono::milliseconds(20));
+        TEST_CHECK(lock.owns_lock());
+        TEST_CHECK(e.waiters.size() == 0);
+
+        // no wait, no suspension
+        TEST_CHECK(!e.waiters.wait_for(lock, std::chrono::milliseconds(0)));
+    }
+
+    void test_predicate_times_out()
+    {
+        event e;
+        wait_queue::lock_type lock(e.cs);
+        TEST_CHECK(!e.waiters.wait_for(lock, std::chrono::milliseconds(20), [&e]() { return e.set; }));
+        TEST_CHECK(e.waiters.size() == 0);
+    }
+
+    void wait_set(event *e)
+    {
+        wait_queue::lock_type lock(e->cs);
+        if (e->waiters.wait_for(lock, std::chrono::seconds(10), [e]() { return e->set; }))
+        {
+            e->woken++;
+        }
+    }
+
+    void test_notify_before_timeout()
+    {
+        event e;
+        static_thread<4096> a(wait_set, &e), b(wait_set, &e);
+        this_thread::sleep_for(std::chrono::milliseconds(10));
+        {
+            wait_queue::lock_type lock(e.cs);
+            TEST_CHECK(e.waiters.size() == 2);
+            e.set = true;
+            TEST_CHECK(e.waiters.notify_all(lock) == 2);
+            TEST_CHECK(!lock.owns_lock());
+        }
+        a.join();
+        b.join();
+        TEST_CHECK(e.woken == 2);
+        TEST_CHECK(e.waiters.size() == 0);
+    }
+
+    void wait_short(event *e)
+    {
+        wait_queue::lock_type lock(e->cs);
+        if (!e->waiters.wait_for(lock, std::chrono::milliseconds(10)))
+        {
+            e->woken++;
+        }
+    }
+
+    void test_timed_out_waiter_leaves_queue()
+    {
+        // the long waiter stays queued while the short one times out from in front of it
+        event e;
+        static_thread<4096> a(wait_short, &e);
+        this_thread::sleep_for(std::chrono::milliseconds(2));
+        static_thread<4096> b(wait_set, &e);
+        a.join();
+        {
+            wait_queue::lock_type lock(e.cs);
+            TEST_CHECK(e.woken == 1);
+            TEST_CHECK(e.waiters.size() == 1);
+            e.set = true;
+            TEST_CHECK(e.waiters.notify_one(lock) == 1);
+        }
+        b.join();
+        TEST_CHECK(e.woken == 2);
+        TEST_CHECK(e.waiters.size() == 0);
+    }
+}
+
+int main()
+{
+    test_wait_times_out();
+    test_predicate_times_out();
+    test_notify_before_timeout();
+    test_timed_out_waiter_leaves_queue();
+    return test::result();
+}
@@ -0,0 +1,105 @@
+/**
+ * @file      watchdog_test.cpp
+ * @brief     Tests of the software watchdog
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "test.h"
+#include "threadx/watchdog.h"
+#include "threadx/semaphore.h"
+#include <atomic>
+
+using namespace threadx;
+
+namespace
+{
+    std::atomic<int> reports { 0 };
+    thread *reported = nullptr;
+
+    void on_stall(const watchdog::report& r)
+    {
+        reports++;
+        reported = &r.thread;
+        TEST_CHECK(r.since_kick >= std::chrono::milliseconds(10));
+    }
+
+    struct worker_context
+    {
+        watchdog::entry *entry = nullptr;
+        std::atomic<bool> stop { false };
+    };
+
+    void kick_periodically(worker_context *ctx)
+    {
+        while (!ctx->stop)
+        {
+            if (ctx->entry != nullptr)
+            {
+                ctx->entry->kick();
+            }
+            this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+
+    void wait_for_release(binary_semaphore *sem)
+    {
+        sem->acquire();
+    }
+
+    void test_stall_reported_once()
+    {
+        watchdog wd(on_stall, std::chrono::milliseconds(5));
+        worker_context ctx;
+        binary_semaphore sem(0);
+        static_thread<4096> live(kick_periodically, &ctx), stalled(wait_for_release, &sem);
+        watchdog::entry live_entry(wd, live, std::chrono::milliseconds(10));
+        watchdog::entry stalled_entry(wd, stalled, std::chrono::milliseconds(10));
+        ctx.entry = &live_entry;
+
+        TEST_CHECK(wd.check() == 0);
+        this_thread::sleep_for(std::chrono::milliseconds(30));
+
+        // only the thread that stopped kicking is reported, and only once
+        TEST_CHECK(wd.check() == 1);
+        TEST_CHECK((reports == 1) && (reported == &stalled));
+        TEST_CHECK(wd.check() == 1);
+        TEST_CHECK(reports == 1);
+
+        // kicking the entry clears the stall, a new stall is reported again
+        stalled_entry.kick();
+        TEST_CHECK(wd.check() == 0);
+        this_thread::sleep_for(std::chrono::milliseconds(30));
+        TEST_CHECK(wd.check() == 1);
+        TEST_CHECK(reports == 2);
+
+        ctx.stop = true;
+        live.join();
+        sem.release();
+        stalled.join();
+    }
+}
+
+int main()
+{
+    test_stall_reported_once();
+    return test::result();
+}
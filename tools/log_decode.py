@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+#
+# Formats the records of the deferred log (include/threadx/deferred_log.h) on the host.
+#
+# The format strings are read from the .threadx_log section of the application's ELF file,
+# the records are read as the raw words shipped by deferred_log::drain, e.g.:
+#   tools/log_decode.py firmware.elf uart_capture.bin
+# The byte order and the size of the target's pointers and longs are taken from the stream headers.
+#
+import argparse
+import re
+import struct
+import sys
+
+RECORD_MAGIC = 0x4C470000
+STREAM_MAGIC = 0x4C530000
+BYTE_ORDER_MARK = 0x01020304
+SECTION = '.threadx_log'
+
+CONVERSION = re.compile(r'%([-+ #0]*\d*(?:\.\d+)?)(hh|h|ll|l|j|z|t|L)?([diouxXcspfFeEgGaA%])')
+
+
+def read_section(path, name):
+    """Returns the load address and the contents of an ELF section."""
+    with open(path, 'rb') as f:
+        elf = f.read()
+    if elf[:4] != b'\x7fELF':
+        sys.exit('%s is not an ELF file' % path)
+    is64 = elf[4] == 2
+    endian = '<' if elf[5] == 1 else '>'
+    if is64:
+        shoff, = struct.unpack_from(endian + 'Q', elf, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH', elf, 0x3A)
+        shdr = endian + 'IIQQQQIIQQ'
+    else:
+        shoff, = struct.unpack_from(endian + 'I', elf, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH', elf, 0x2E)
+        shdr = endian + 'IIIIIIIIII'
+
+    sections = [struct.unpack_from(shdr, elf, shoff + i * shentsize) for i in range(shnum)]
+    strtab = sections[shstrndx]
+    for s in sections:
+        start = strtab[4] + s[0]
+        if elf[start:elf.index(b'\0', start)].decode() == name:
+            return s[3], elf[s[4]:s[4] + s[5]]
+    sys.exit('%s has no %s section' % (path, name))
+
+
+def combine(words, endian):
+    """Returns the value of a multi-word argument, stored in the target's byte order."""
+    if endian == '>':
+        words = reversed(words)
+    value = 0
+    for i, word in enumerate(words):
+        value |= word << (32 * i)
+    return value
+
+
+def format_message(fmt, args, layout):
+    """Formats the raw argument words according to the printf-style format string."""
+    endian, pointer_words, long_words = layout
+    words = list(args)
+
+    def take(count, signed):
+        value = combine([words.pop(0) if words else 0 for _ in range(count)], endian)
+        if signed and value & (1 << (32 * count - 1)):
+            value -= 1 << (32 * count)
+        return value
+
+    def convert(m):
+        flags, length, conv = m.groups()
+        if conv == '%':
+            return '%'
+        if conv in 'fFeEgGaA':
+            raw = take(2, False)
+            value = struct.unpack('<d', struct.pack('<Q', raw))[0]
+            return ('%' + flags + (conv if conv not in 'aA' else 'e')) % value
+        count = {'ll': 2, 'j': 2, 'l': long_words, 'z': pointer_words, 't': pointer_words}.get(length, 1)
+        if conv in 'ps':
+            return '0x%x' % take(pointer_words, False)
+        value = take(count, conv in 'di')
+        if conv == 'c':
+            return ('%' + flags + 'c') % chr(value & 0xFF)
+        if conv == 'i':
+            conv = 'd'
+        return ('%' + flags + conv) % value
+
+    return CONVERSION.sub(convert, fmt)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Formats the records of the deferred log.')
+    parser.add_argument('elf', help='the application ELF file, holding the format strings')
+    parser.add_argument('log', help='the binary log records, - for stdin')
+    args = parser.parse_args()
+
+    base, strings = read_section(args.elf, SECTION)
+    stream = sys.stdin.buffer.read() if args.log == '-' else open(args.log, 'rb').read()
+    count = len(stream) // 4
+    words = {e: struct.unpack(e + '%dI' % count, stream[:count * 4]) for e in '<>'}
+
+    # until the first stream header, a little-endian 32-bit target is assumed
+    layout = ('<', 1, 1)
+    i = 0
+    while i < count:
+        # the stream header's mark reveals the byte order of the records that follow
+        for endian in '<>':
+            header = words[endian][i]
+            if ((header & ~0xFFFF) == STREAM_MAGIC and (header & 0xFFFF) >= 3 and i + 3 <= count and
+                    words[endian][i + 1] == BYTE_ORDER_MARK):
+                sizes = words[endian][i + 2]
+                layout = (endian, max(1, (sizes & 0xFF) // 4), max(1, ((sizes >> 8) & 0xFF) // 4))
+                i += header & 0xFFFF
+                break
+        else:
+            endian, pointer_words, _ = layout
+            header_words = 2 + 2 * pointer_words
+            header = words[endian][i]
+            size = header & 0xFFFF
+            if (header & ~0xFFFF) != RECORD_MAGIC or size < header_words or i + size > count:
+                # resynchronize on the next record
+                i += 1
+                continue
+            record = words[endian][i:i + size]
+            address = combine(record[1:1 + pointer_words], endian)
+            timestamp = record[1 + pointer_words]
+            thread = combine(record[2 + pointer_words:header_words], endian)
+            offset = address - base
+            if 0 <= offset < len(strings):
+                fmt = strings[offset:strings.index(b'\0', offset)].decode(errors='replace')
+                message = format_message(fmt, record[header_words:], layout)
+            else:
+                message = '<unknown format 0x%08x>' % address
+            print('%10u %s %s' % (timestamp, 'isr       ' if thread == 0 else '0x%08x' % thread, message))
+            i += size
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+#
+# Folds the samples of the sampling profiler (include/threadx/sampling_profiler.h) into
+# the "folded stacks" format, which flame graph tools (flamegraph.pl, speedscope) take as input.
+#
+# The samples are read as the raw little-endian words shipped by sampling_profiler::drain,
+# the program counters are resolved to functions with the toolchain's addr2line, e.g.:
+#   tools/profile_fold.py samples.bin --elf firmware.elf --addr2line arm-none-eabi-addr2line > profile.folded
+#   flamegraph.pl profile.folded > profile.svg
+#
+import argparse
+import collections
+import struct
+import subprocess
+import sys
+
+
+def read_threads(path):
+    """Reads the thread names from lines of '<id> <name>'."""
+    names = {}
+    if path:
+        with open(path) as f:
+            for line in f:
+                fields = line.split(None, 1)
+                if len(fields) == 2:
+                    names[int(fields[0], 0)] = fields[1].strip()
+    return names
+
+
+def resolve(addresses, elf, addr2line):
+    """Maps the program counters to function names."""
+    functions = {0: '[unknown]'}
+    addresses = sorted(a for a in addresses if a != 0)
+    if not elf or not addresses:
+        functions.update((a, '0x%08x' % a) for a in addresses)
+        return functions
+    output = subprocess.run([addr2line, '-f', '-C', '-e', elf] + ['0x%x' % a for a in addresses],
+                            check=True, stdout=subprocess.PIPE, universal_newlines=True).stdout.splitlines()
+    for a, name in zip(addresses, output[0::2]):
+        functions[a] = name if name != '??' else '0x%08x' % a
+    return functions
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Folds the profiler samples for flame graphs.')
+    parser.add_argument('samples', help='the binary samples, - for stdin')
+    parser.add_argument('--elf', help='the application ELF file, to resolve the functions')
+    parser.add_argument('--addr2line', default='addr2line', help='the addr2line tool of the target toolchain')
+    parser.add_argument('--threads', help='a file of "<id> <name>" lines, to name the threads')
+    parser.add_argument('--threads-only', action='store_true', help='fold the samples per thread only')
+    args = parser.parse_args()
+
+    stream = sys.stdin.buffer.read() if args.samples == '-' else open(args.samples, 'rb').read()
+    words = struct.unpack('<%dI' % (len(stream) // 4), stream[:len(stream) // 4 * 4])
+    samples = collections.Counter(zip(words[0::2], words[1::2]))
+
+    names = read_threads(args.threads)
+    functions = resolve({pc for _, pc in samples}, args.elf, args.addr2line) if not args.threads_only else {}
+
+    folded = collections.Counter()
+    for (thread, pc), count in samples.items():
+        frame = 'idle' if thread == 0 else names.get(thread, '0x%08x' % thread)
+        if not args.threads_only:
+            frame += ';' + functions[pc]
+        folded[frame] += count
+
+    for frame, count in sorted(folded.items()):
+        print('%s %d' % (frame, count))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,317 @@
+/**
+ * @file      size_features.cpp
+ * @brief     Representative feature uses for the footprint report
+ * @author    Benedek Kupper
+ *
+ * Copyright (c) 2021 Benedek Kupper
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+// Representative uses of the library features, each one selected by a FEATURE_* macro.
+// tools/size_report.sh compiles this file once per feature, and reports the size
+// difference to the compilation without any feature.
+#include "threadx/ceiling_mutex.h"
+#include "threadx/channel.h"
+#include "threadx/cpu_budget.h"
+#include "threadx/cyclic_executive.h"
+#include "threadx/deadline_queue.h"
+#include "threadx/deferred_log.h"
+#include "threadx/io_completion_port.h"
+#include "threadx/lazy.h"
+#include "threadx/metrics.h"
+#include "threadx/mutex.h"
+#include "threadx/parallel.h"
+#include "threadx/ping_pong_buffer.h"
+#include "threadx/rate_limiter.h"
+#include "threadx/rpc_server.h"
+#include "threadx/sampling_profiler.h"
+#include "threadx/semaphore.h"
+#include "threadx/thread.h"
+#include "threadx/thread_group.h"
+#include "threadx/thread_pool.h"
+#include "threadx/triple_buffer.h"
+#include "threadx/wait_queue.h"
+#include "threadx/watchdog.h"
+
+using namespace threadx;
+
+struct worker
+{
+    void run() {}
+};
+worker w;
+void entry(native::ULONG) {}
+void entry_value(int) {}
+void entry_pointer(worker*) {}
+
+#if defined(FEATURE_STATIC_THREAD_FUNCTION)
+static_thread<512> t(&entry, nullptr);
+#endif
+
+#if defined(FEATURE_STATIC_THREAD_VALUE)
+static_thread<512> t(&entry_value, 1);
+#endif
+
+#if defined(FEATURE_STATIC_THREAD_POINTER)
+static_thread<512> t(&entry_pointer, &w);
+#endif
+
+#if defined(FEATURE_STATIC_THREAD_REFERENCE)
+static_thread<512> t(&entry_pointer, w);
+#endif
+
+#if defined(FEATURE_STATIC_THREAD_MEMBER)
+static_thread<512> t(w, &worker::run);
+#endif
+
+#if defined(FEATURE_THREAD_JOIN) && !defined(TX_DISABLE_NOTIFY_CALLBACKS)
+void use(thread& t)
+{
+    t.join();
+}
+#endif
+
+#if defined(FEATURE_MUTEX)
+mutex m;
+void use()
+{
+    lock_guard<mutex> lock(m);
+}
+#endif
+
+#if defined(FEATURE_SEMAPHORE)
+binary_semaphore s;
+void use()
+{
+    s.release();
+    (void)s.try_acquire_for(std::chrono::milliseconds(10));
+}
+#endif
+
+#if defined(FEATURE_CHANNEL)
+channel<int, 8> c;
+int use(int v)
+{
+    c.send(v);
+    (void)c.receive(v);
+    return v;
+}
+#endif
+
+#if defined(FEATURE_RENDEZVOUS_CHANNEL)
+channel<int, 0> c;
+int use(int v)
+{
+    c.send(v);
+    (void)c.receive(v);
+    return v;
+}
+#endif
+
+#if defined(FEATURE_RATE_LIMITER)
+rate_limiter r(10, 1, std::chrono::milliseconds(100));
+bool use()
+{
+    return r.try_acquire_for(1, std::chrono::milliseconds(500));
+}
+#endif
+
+#if defined(FEATURE_WATCHDOG)
+void on_stall(const watchdog::report&) {}
+watchdog wd(&on_stall, std::chrono::milliseconds(100));
+#endif
+
+#if defined(FEATURE_TRIPLE_BUFFER)
+triple_buffer<int> b;
+int use(int v)
+{
+    b.write_buffer() = v;
+    b.publish();
+    b.update_wait();
+    return b.read_buffer();
+}
+#endif
+
+#if defined(FEATURE_PING_PONG_BUFFER)
+ping_pong_buffer<int> b;
+int use(int v)
+{
+    b.begin_write() = v;
+    b.end_write();
+    v = b.begin_read();
+    b.end_read();
+    return v;
+}
+#endif
+
+#if defined(FEATURE_PARALLEL)
+static_worker_team<512> team;
+int data[64];
+int use()
+{
+    parallel_for(team, 0, 64, 8, [](std::size_t i) { data[i] = static_cast<int>(i); });
+    return parallel_reduce(team, 0, 64, 8, 0,
+            [](std::size_t i) { return data[i]; }, [](int a, int b) { return a + b; });
+}
+#endif
+
+#if defined(FEATURE_THREAD_POOL) && !defined(TX_DISABLE_NOTIFY_CALLBACKS)
+static_thread_pool<512, 4> pool;
+void use()
+{
+    pool.create(&entry_pointer, &w).detach();
+}
+#endif
+
+#if defined(FEATURE_LAZY)
+lazy<worker> singleton;
+void use()
+{
+    singleton->run();
+}
+#endif
+
+#if defined(FEATURE_WAIT_QUEUE)
+wait_queue q;
+bool ready;
+void use()
+{
+    cpu::critical_section cs;
+    wait_queue::lock_type lock(cs);
+    q.wait(lock, []() { return ready; });
+}
+void notify()
+{
+    cpu::critical_section cs;
+    wait_queue::lock_type lock(cs);
+    ready = true;
+    q.notify_all(lock);
+}
+#endif
+
+#if defined(FEATURE_DEADLINE_QUEUE)
+deadline_queue<int, 8> dq;
+int use(int v)
+{
+    dq.push(v, tick_timer::now() + tick_timer::duration(10));
+    dq.wait_pop_until_due(v);
+    return v;
+}
+#endif
+
+#if defined(FEATURE_IO_COMPLETION_PORT)
+io_completion_port port;
+void on_done(io_operation&) {}
+io_operation op(&on_done);
+std::size_t use()
+{
+    port.submit(op);
+    port.complete(op, 0);
+    return port.dispatch(1);
+}
+#endif
+
+#if defined(FEATURE_CEILING_MUTEX) && !defined(TX_DISABLE_PREEMPTION_THRESHOLD)
+ceiling_mutex<5> cm;
+void use()
+{
+    lock_guard<ceiling_mutex<5>> lock(cm);
+}
+#endif
+
+#if defined(FEATURE_RPC_SERVER)
+rpc_server<int, int> server;
+rpc_server<int, int>::client server_client(server);
+int use(int v)
+{
+    server_client.call(v, v);
+    return v;
+}
+void serve()
+{
+    server.serve_one([](const int& request, int& response) { response = request + 1; });
+}
+#endif
+
+#if defined(FEATURE_CYCLIC_EXECUTIVE)
+void step() {}
+cyclic_executive::slot table[] = {
+    { &step, tick_timer::duration(10) },
+    { &step, tick_timer::duration(20), tick_timer::duration(5) },
+};
+cyclic_executive executive(table);
+void use()
+{
+    executive.run();
+}
+#endif
+
+#if defined(FEATURE_CPU_BUDGET)
+cpu_budget budget(tick_timer::duration(5), tick_timer::duration(50));
+void use(thread& t)
+{
+    cpu_budget::member m(budget, t);
+}
+void tick()
+{
+    cpu_budget::on_tick();
+}
+#endif
+
+#if defined(FEATURE_THREAD_GROUP)
+static_thread_group<2> group;
+static_thread<512> first(&entry_pointer, &w), second(&entry_pointer, &w);
+void use()
+{
+    group.start_all();
+}
+#endif
+
+#if defined(FEATURE_DEFERRED_LOG)
+void ship(const deferred_log::word *, std::size_t) {}
+std::size_t use(int v)
+{
+    THREADX_LOG("value %d", v);
+    return deferred_log::drain(&ship);
+}
+#endif
+
+#if defined(FEATURE_METRICS)
+counter events("events");
+gauge depth("depth");
+histogram latency("latency");
+void use(std::uint32_t v)
+{
+    events.add();
+    depth.add(1);
+    latency.record(v);
+}
+#endif
+
+#if defined(FEATURE_SAMPLING_PROFILER)
+void ship(const sampling_profiler::sample *, std::size_t) {}
+void use(const void *pc)
+{
+    sampling_profiler::on_tick(pc);
+}
+std::size_t drain()
+{
+    return sampling_profiler::drain(&ship);
+}
+#endif
@@ -0,0 +1,56 @@
+#!/bin/sh
+#
+# Reports the code footprint (.text, .data, .bss) of the library's translation units
+# in each configuration, and of each feature in tools/size_features.cpp.
+#
+# The toolchain and the ThreadX include paths are taken from the environment, e.g.:
+#   CXX=arm-none-eabi-g++ SIZE=arm-none-eabi-size \
+#   CXXFLAGS="-Os -mcpu=cortex-m4 -mthumb -I<threadx>/common/inc -I<threadx>/ports/cortex_m4/gnu/inc" \
+#   tools/size_report.sh
+#
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+CXX=${CXX:-g++}
+SIZE=${SIZE:-size}
+CXXFLAGS=${CXXFLAGS:--Os}
+CONFIGS=${CONFIGS:-"-DTHREADX_MCPP_DISABLE_ERROR_CHECKING -DTX_DISABLE_NOTIFY_CALLBACKS -DTHREADX_MCPP_CXA_GUARD -DTHREADX_MCPP_CRITICAL_SECTION_STATS"}
+
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+
+# prints the text, data and bss size of a source compiled with the given flags
+measure()
+{
+    src=$1
+    shift
+    $CXX $CXXFLAGS -I"$ROOT/include" -ffunction-sections -fdata-sections "$@" -c "$src" -o "$OUT/size.o"
+    $SIZE "$OUT/size.o" | awk 'NR == 2 { print $1, $2, $3 }'
+}
+
+row()
+{
+    printf '%-40s %8s %8s %8s\n' "$1" "$2" "$3" "$4"
+}
+
+for config in "" $CONFIGS; do
+    echo "library sources ${config:-(default configuration)}"
+    row "source" ".text" ".data" ".bss"
+    total_text=0 total_data=0 total_bss=0
+    for src in "$ROOT"/src/*.cpp; do
+        set -- $(measure "$src" $config)
+        row "$(basename "$src")" "$1" "$2" "$3"
+        total_text=$((total_text + $1)) total_data=$((total_data + $2)) total_bss=$((total_bss + $3))
+    done
+    row "total" "$total_text" "$total_data" "$total_bss"
+    echo
+done
+
+echo "features (difference to the empty translation unit)"
+row "feature" ".text" ".data" ".bss"
+set -- $(measure "$ROOT/tools/size_features.cpp")
+base_text=$1 base_data=$2 base_bss=$3
+for feature in $(grep -o 'defined(FEATURE_[A-Z_]*)' "$ROOT/tools/size_features.cpp" | sed 's/defined(\(.*\))/\1/' | sort -u); do
+    set -- $(measure "$ROOT/tools/size_features.cpp" -D"$feature")
+    row "$feature" "$(($1 - base_text))" "$(($2 - base_data))" "$(($3 - base_bss))"
+done